@@ -0,0 +1,83 @@
+#-------------------------------------------------------------------------------
+# Turns resources/mamenames.xml, mamebioses.xml and mamedevices.xml into C++ tables
+# that MameNames uses when built with MAMENAMES_BUILTIN, so nothing is parsed at startup.
+#
+#   cmake -DRESOURCES_DIR=<resources> -DOUTPUT=<file.cpp> -P GenerateMameNames.cmake
+#
+# Every table is sorted by MAME name (byte order, like strcmp).
+#-------------------------------------------------------------------------------
+
+# ';', '[' and ']' would split or merge CMake list elements, they're swapped for
+# control characters while the entries are sorted and restored afterwards
+string(ASCII 1 SEMICOLON)
+string(ASCII 2 OPEN_BRACKET)
+string(ASCII 3 CLOSE_BRACKET)
+
+# XML text to the content of a C string literal, one entry per line
+macro(mamenames_prepare VAR)
+	string(REPLACE "\\" "\\\\" ${VAR} "${${VAR}}")
+	string(REPLACE "\"" "\\\"" ${VAR} "${${VAR}}")
+	string(REPLACE "&quot;" "\\\"" ${VAR} "${${VAR}}")
+	string(REPLACE "&apos;" "'" ${VAR} "${${VAR}}")
+	string(REPLACE "&lt;" "<" ${VAR} "${${VAR}}")
+	string(REPLACE "&gt;" ">" ${VAR} "${${VAR}}")
+	string(REPLACE "&amp;" "&" ${VAR} "${${VAR}}")
+	string(REPLACE ";" "${SEMICOLON}" ${VAR} "${${VAR}}")
+	string(REPLACE "[" "${OPEN_BRACKET}" ${VAR} "${${VAR}}")
+	string(REPLACE "]" "${CLOSE_BRACKET}" ${VAR} "${${VAR}}")
+	string(REGEX REPLACE "\r" "" ${VAR} "${${VAR}}")
+endmacro()
+
+# sorts the entries matched by REGEX, formatted with REPLACEMENT, into a table body
+function(mamenames_table VAR FILE REGEX REPLACEMENT)
+	file(READ "${RESOURCES_DIR}/${FILE}" CONTENT)
+	mamenames_prepare(CONTENT)
+
+	string(REGEX MATCHALL "${REGEX}" ENTRIES "${CONTENT}")
+	set(LINES "")
+	foreach(ENTRY ${ENTRIES})
+		string(REGEX REPLACE "${REGEX}" "${REPLACEMENT}" LINE "${ENTRY}")
+		list(APPEND LINES "${LINE}")
+	endforeach()
+	list(SORT LINES)
+	list(LENGTH LINES COUNT)
+
+	string(REPLACE ";" ",\n\t" TABLE "${LINES}")
+	string(REPLACE "${SEMICOLON}" ";" TABLE "${TABLE}")
+	string(REPLACE "${OPEN_BRACKET}" "[" TABLE "${TABLE}")
+	string(REPLACE "${CLOSE_BRACKET}" "]" TABLE "${TABLE}")
+	set(${VAR} "${TABLE}" PARENT_SCOPE)
+
+	message(STATUS "${FILE}: ${COUNT} entries")
+endfunction()
+
+mamenames_table(NAMES "mamenames.xml"
+	"<mamename>([^<]*)</mamename>[ \t\n]*<realname>([^<]*)</realname>"
+	"{ \"\\1\", \"\\2\" }")
+mamenames_table(BIOSES "mamebioses.xml" "<bios>([^<]*)</bios>" "\"\\1\"")
+mamenames_table(DEVICES "mamedevices.xml" "<device>([^<]*)</device>" "\"\\1\"")
+
+file(WRITE "${OUTPUT}.tmp"
+"// Generated by CMake/Utils/GenerateMameNames.cmake from resources/mame*.xml, don't edit.
+
+#include <stddef.h>
+
+extern const char* const gMameNames[][2] = {
+	${NAMES}
+};
+extern const size_t gMameNameCount = sizeof(gMameNames) / sizeof(gMameNames[0]);
+
+extern const char* const gMameBioses[] = {
+	${BIOSES}
+};
+extern const size_t gMameBiosCount = sizeof(gMameBioses) / sizeof(gMameBioses[0]);
+
+extern const char* const gMameDevices[] = {
+	${DEVICES}
+};
+extern const size_t gMameDeviceCount = sizeof(gMameDevices) / sizeof(gMameDevices[0]);
+")
+
+# only touch the output if it changed, so it's not compiled again for nothing
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -45,6 +45,7 @@ CollectionSystemManager::CollectionSystemManager(Window* window) : mWindow(windo
 	mCollectionEnvData->mStartPath = "";
 	std::vector<std::string> exts;
 	mCollectionEnvData->mSearchExtensions = exts;
+	mCollectionEnvData->mExtensionMatcher.setExtensions(exts, false);
 	mCollectionEnvData->mLaunchCommand = "";
 	std::vector<PlatformIds::PlatformId> allPlatformIds;
 	allPlatformIds.push_back(PlatformIds::PLATFORM_IGNORE);
@@ -100,7 +101,7 @@ void CollectionSystemManager::deinit()
 void CollectionSystemManager::saveCustomCollection(SystemData* sys)
 {
 	std::string name = sys->getName();
-	std::unordered_map<std::string, FileData*> games = sys->getRootFolder()->getChildrenByFilename();
+	FileData::ChildMap games = sys->getRootFolder()->getChildrenByFilename();
 	bool found = mCustomCollectionSystemsData.find(name) != mCustomCollectionSystemsData.cend();
 	if (found) {
 		CollectionSystemData sysData = mCustomCollectionSystemsData.at(name);
@@ -108,7 +109,7 @@ void CollectionSystemManager::saveCustomCollection(SystemData* sys)
 		{
 			std::ofstream configFile;
 			configFile.open(getCustomCollectionConfigPath(name));
-			for(std::unordered_map<std::string, FileData*>::const_iterator iter = games.cbegin(); iter != games.cend(); ++iter)
+			for(FileData::ChildMap::const_iterator iter = games.cbegin(); iter != games.cend(); ++iter)
 			{
 				std::string path =  iter->first;
 				configFile << path << std::endl;
@@ -242,7 +243,7 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, CollectionS
 		std::string key = file->getFullPath();
 
 		SystemData* curSys = sysData.system;
-		const std::unordered_map<std::string, FileData*>& children = curSys->getRootFolder()->getChildrenByFilename();
+		const FileData::ChildMap& children = curSys->getRootFolder()->getChildrenByFilename();
 		bool found = children.find(key) != children.cend();
 		FileData* rootFolder = curSys->getRootFolder();
 		FileFilterIndex* fileIndex = curSys->getIndex();
@@ -255,29 +256,31 @@ void CollectionSystemManager::updateCollectionSystem(FileData* file, CollectionS
 			fileIndex->removeFromIndex(collectionEntry);
 			collectionEntry->refreshMetadata();
 			// found and we are removing
-			if (name == "favorites" && file->metadata.get("favorite") == "false") {
+			if (name == "favorites" && file->metadata.get(META_FAVORITE) == "false") {
 				// need to check if still marked as favorite, if not remove
 				ViewController::get()->getGameListView(curSys).get()->remove(collectionEntry, false);
 			}
 			else
 			{
-				// re-index with new metadata
+				// re-index with new metadata and move it to its new place, so the sort below has nothing left to do
 				fileIndex->addToIndex(collectionEntry);
+				rootFolder->repositionChild(collectionEntry);
 				ViewController::get()->onFileChanged(collectionEntry, FILE_METADATA_CHANGED);
 			}
 		}
 		else
 		{
 			// we didn't find it here - we need to check if we should add it
-			if (name == "recent" && file->metadata.get("playcount") > "0" && includeFileInAutoCollections(file) ||
-				name == "favorites" && file->metadata.get("favorite") == "true") {
-				CollectionFileData* newGame = new CollectionFileData(file, curSys);
+			if (name == "recent" && file->metadata.getInt(META_PLAYCOUNT) > 0 && includeFileInAutoCollections(file) ||
+				name == "favorites" && file->metadata.getBool(META_FAVORITE)) {
+				CollectionFileData* newGame = new (curSys->getArena()) CollectionFileData(file, curSys);
 				rootFolder->addChild(newGame);
 				fileIndex->addToIndex(newGame);
 				ViewController::get()->onFileChanged(file, FILE_METADATA_CHANGED);
 				ViewController::get()->getGameListView(curSys)->onFileChanged(newGame, FILE_METADATA_CHANGED);
 			}
 		}
+		// only a full sort if the collection was sorted some other way meanwhile, new games were inserted in place
 		rootFolder->sort(getSortTypeFromString(mCollectionSystemDeclsIndex[name].defaultSort));
 		if (name == "recent")
 		{
@@ -313,7 +316,7 @@ void CollectionSystemManager::deleteCollectionFiles(FileData* file)
 	{
 		if (sysDataIt->second.isPopulated)
 		{
-			const std::unordered_map<std::string, FileData*>& children = (sysDataIt->second.system)->getRootFolder()->getChildrenByFilename();
+			const FileData::ChildMap& children = (sysDataIt->second.system)->getRootFolder()->getChildrenByFilename();
 
 			bool found = children.find(key) != children.cend();
 			if (found) {
@@ -471,7 +474,7 @@ bool CollectionSystemManager::toggleGameInCollection(FileData* file)
 			}
 			std::string key = file->getFullPath();
 			FileData* rootFolder = sysData->getRootFolder();
-			const std::unordered_map<std::string, FileData*>& children = rootFolder->getChildrenByFilename();
+			const FileData::ChildMap& children = rootFolder->getChildrenByFilename();
 			bool found = children.find(key) != children.cend();
 			FileFilterIndex* fileIndex = sysData->getIndex();
 			std::string name = sysData->getName();
@@ -494,7 +497,7 @@ bool CollectionSystemManager::toggleGameInCollection(FileData* file)
 			else
 			{
 				// we didn't find it here, we should add it
-				CollectionFileData* newGame = new CollectionFileData(file, sysData);
+				CollectionFileData* newGame = new (sysData->getArena()) CollectionFileData(file, sysData);
 				rootFolder->addChild(newGame);
 				fileIndex->addToIndex(newGame);
 				ViewController::get()->getGameListView(systemViewToUpdate)->onFileChanged(newGame, FILE_METADATA_CHANGED);
@@ -524,7 +527,7 @@ bool CollectionSystemManager::toggleGameInCollection(FileData* file)
 			}
 			file->getSourceFileData()->getSystem()->getIndex()->addToIndex(file);
 
-			file->getSourceFileData()->getSystem()->onMetaDataSavePoint();
+			file->getSourceFileData()->getSystem()->onStatisticsSavePoint(file->getSourceFileData());
 
 			refreshCollectionSystems(file->getSourceFileData());
 		}
@@ -548,7 +551,7 @@ SystemData* CollectionSystemManager::getSystemToView(SystemData* sys)
 	FileData* rootFolder = sys->getRootFolder();
 
 	FileData* bundleRootFolder = mCustomCollectionsBundle->getRootFolder();
-	const std::unordered_map<std::string, FileData*>& bundleChildren = bundleRootFolder->getChildrenByFilename();
+	const FileData::ChildMap& bundleChildren = bundleRootFolder->getChildrenByFilename();
 
 	// is the rootFolder bundled in the "My Collections" system?
 	bool sysFoundInBundle = bundleChildren.find(rootFolder->getKey()) != bundleChildren.cend();
@@ -590,22 +593,22 @@ void CollectionSystemManager::updateCollectionFolderMetadata(SystemData* sys)
 	std::string thumbnail = "";
 	std::string image = "";
 
-	std::unordered_map<std::string, FileData*> games = rootFolder->getChildrenByFilename();
+	FileData::ChildMap games = rootFolder->getChildrenByFilename();
 
 	if(games.size() > 0)
 	{
 		std::string games_list = "";
 		int games_counter = 0;
-		for(std::unordered_map<std::string, FileData*>::const_iterator iter = games.cbegin(); iter != games.cend(); ++iter)
+		for(FileData::ChildMap::const_iterator iter = games.cbegin(); iter != games.cend(); ++iter)
 		{
 			games_counter++;
 			FileData* file = iter->second;
 
-			std::string new_rating = file->metadata.get("rating");
-			std::string new_releasedate = file->metadata.get("releasedate");
-			std::string new_developer = file->metadata.get("developer");
-			std::string new_genre = file->metadata.get("genre");
-			std::string new_players = file->metadata.get("players");
+			std::string new_rating = file->metadata.get(META_RATING);
+			std::string new_releasedate = file->metadata.get(META_RELEASEDATE);
+			std::string new_developer = file->metadata.get(META_DEVELOPER);
+			std::string new_genre = file->metadata.get(META_GENRE);
+			std::string new_players = file->metadata.get(META_PLAYERS);
 
 			rating = (new_rating > rating ? (new_rating != "" ? new_rating : rating) : rating);
 			players = (new_players > players ? (new_players != "" ? new_players : players) : players);
@@ -636,15 +639,15 @@ void CollectionSystemManager::updateCollectionFolderMetadata(SystemData* sys)
 	}
 
 
-	rootFolder->metadata.set("desc", desc);
-	rootFolder->metadata.set("rating", rating);
-	rootFolder->metadata.set("players", players);
-	rootFolder->metadata.set("genre", genre);
-	rootFolder->metadata.set("releasedate", releasedate);
-	rootFolder->metadata.set("developer", developer);
-	rootFolder->metadata.set("video", video);
-	rootFolder->metadata.set("thumbnail", thumbnail);
-	rootFolder->metadata.set("image", image);
+	rootFolder->metadata.set(META_DESC, desc);
+	rootFolder->metadata.set(META_RATING, rating);
+	rootFolder->metadata.set(META_PLAYERS, players);
+	rootFolder->metadata.set(META_GENRE, genre);
+	rootFolder->metadata.set(META_RELEASEDATE, releasedate);
+	rootFolder->metadata.set(META_DEVELOPER, developer);
+	rootFolder->metadata.set(META_VIDEO, video);
+	rootFolder->metadata.set(META_THUMBNAIL, thumbnail);
+	rootFolder->metadata.set(META_IMAGE, image);
 }
 
 void CollectionSystemManager::initCustomCollectionSystems()
@@ -705,6 +708,9 @@ SystemData* CollectionSystemManager::createNewCollectionEntry(std::string name,
 // populates an Automatic Collection System
 void CollectionSystemManager::populateAutoCollection(CollectionSystemData* sysData)
 {
+	// auto collections are built from every game of every system
+	SystemData::loadAllGameLists();
+
 	SystemData* newSys = sysData->system;
 	CollectionSystemDecl sysDecl = sysData->decl;
 	FileData* rootFolder = newSys->getRootFolder();
@@ -713,22 +719,22 @@ void CollectionSystemManager::populateAutoCollection(CollectionSystemData* sysDa
 	{
 		// we won't iterate all collections
 		if ((*sysIt)->isGameSystem() && !(*sysIt)->isCollection()) {
-			std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+			const std::vector<FileData*>& files = (*sysIt)->getGames();
 			for(auto gameIt = files.cbegin(); gameIt != files.cend(); gameIt++)
 			{
 				bool include = includeFileInAutoCollections((*gameIt));
 				switch(sysDecl.type) {
 					case AUTO_LAST_PLAYED:
-						include = include && (*gameIt)->metadata.get("playcount") > "0";
+						include = include && (*gameIt)->metadata.getInt(META_PLAYCOUNT) > 0;
 						break;
 					case AUTO_FAVORITES:
 						// we may still want to add files we don't want in auto collections in "favorites"
-						include = (*gameIt)->metadata.get("favorite") == "true";
+						include = (*gameIt)->metadata.getBool(META_FAVORITE);
 						break;
 				}
 
 				if (include) {
-					CollectionFileData* newGame = new CollectionFileData(*gameIt, newSys);
+					CollectionFileData* newGame = new (newSys->getArena()) CollectionFileData(*gameIt, newSys);
 					rootFolder->addChild(newGame);
 					index->addToIndex(newGame);
 				}
@@ -756,6 +762,9 @@ void CollectionSystemManager::populateCustomCollection(CollectionSystemData* sys
 	}
 	LOG(LogInfo) << "Loading custom collection config file at " << path;
 
+	// entries can point to games of any system
+	SystemData::loadAllGameLists();
+
 	FileData* rootFolder = newSys->getRootFolder();
 	FileFilterIndex* index = newSys->getIndex();
 
@@ -763,15 +772,15 @@ void CollectionSystemManager::populateCustomCollection(CollectionSystemData* sys
 	std::ifstream input(path);
 
 	// get all files map
-	std::unordered_map<std::string,FileData*> allFilesMap = getAllGamesCollection()->getRootFolder()->getChildrenByFilename();
+	FileData::ChildMap allFilesMap = getAllGamesCollection()->getRootFolder()->getChildrenByFilename();
 
 	// iterate list of files in config file
 
 	for(std::string gameKey; getline(input, gameKey); )
 	{
-		std::unordered_map<std::string,FileData*>::const_iterator it = allFilesMap.find(gameKey);
+		FileData::ChildMap::const_iterator it = allFilesMap.find(gameKey);
 		if (it != allFilesMap.cend()) {
-			CollectionFileData* newGame = new CollectionFileData(it->second, newSys);
+			CollectionFileData* newGame = new (newSys->getArena()) CollectionFileData(it->second, newSys);
 			rootFolder->addChild(newGame);
 			index->addToIndex(newGame);
 		}
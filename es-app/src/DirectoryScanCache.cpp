@@ -0,0 +1,139 @@
+#include "DirectoryScanCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "Log.h"
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SCAN_CACHE_VERSION "esscancache 1"
+
+DirectoryScanCache::DirectoryScanCache(const std::string& path, const std::string& signature) :
+	mPath(path), mSignature(signature), mChanged(false)
+{
+}
+
+void DirectoryScanCache::load()
+{
+	mCached.clear();
+
+	std::ifstream file(mPath);
+	if(!file.good())
+		return;
+
+	std::string line;
+	if(!std::getline(file, line) || line != SCAN_CACHE_VERSION)
+	{
+		LOG(LogInfo) << "Ignoring scan cache \"" << mPath << "\" written by another version";
+		return;
+	}
+
+	if(!std::getline(file, line) || line != mSignature)
+	{
+		LOG(LogInfo) << "Ignoring scan cache \"" << mPath << "\", the system configuration changed";
+		return;
+	}
+
+	// "D <mtime> <path>" starts a directory, followed by its "G <name>" and "F <name>" entries
+	Directory* directory = nullptr;
+	while(std::getline(file, line))
+	{
+		if(line.size() < 3 || line[1] != ' ')
+			continue;
+
+		if(line[0] == 'D')
+		{
+			size_t separator = line.find(' ', 2);
+			if(separator == std::string::npos)
+			{
+				directory = nullptr;
+				continue;
+			}
+
+			directory = &mCached[line.substr(separator + 1)];
+			directory->modified = strtoll(line.c_str() + 2, nullptr, 10);
+			directory->entries.clear();
+		}
+		else if(directory && (line[0] == 'G' || line[0] == 'F'))
+		{
+			directory->entries.push_back({ line.substr(2), line[0] == 'G' });
+		}
+	}
+}
+
+void DirectoryScanCache::save()
+{
+	// nothing was rescanned and no directory disappeared, the file on disk is still up to date
+	if(!mChanged && mScanned.size() == mCached.size())
+		return;
+
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(mPath));
+
+	// write to a temporary file first so an interrupted write never leaves a truncated cache behind
+	const std::string tempPath = mPath + ".tmp";
+	std::ofstream file(tempPath, std::ios::out | std::ios::trunc);
+	if(!file.good())
+	{
+		LOG(LogError) << "Error - could not write scan cache \"" << tempPath << "\"";
+		return;
+	}
+
+	file << SCAN_CACHE_VERSION << "\n" << mSignature << "\n";
+	for(auto it = mScanned.cbegin(); it != mScanned.cend(); ++it)
+	{
+		file << "D " << it->second.modified << " " << it->first << "\n";
+		for(auto entry = it->second.entries.cbegin(); entry != it->second.entries.cend(); ++entry)
+			file << (entry->isGame ? "G " : "F ") << entry->name << "\n";
+	}
+
+	file.close();
+	if(file.fail())
+	{
+		LOG(LogError) << "Error - could not write scan cache \"" << tempPath << "\"";
+		Utils::FileSystem::removeFile(tempPath);
+		return;
+	}
+
+	Utils::FileSystem::removeFile(mPath);
+	if(rename(tempPath.c_str(), mPath.c_str()) != 0)
+		LOG(LogError) << "Error - could not rename scan cache \"" << tempPath << "\" to \"" << mPath << "\"";
+}
+
+bool DirectoryScanCache::get(const std::string& path, long long modified, std::vector<Entry>& entries)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mCached.find(path);
+	if(it == mCached.cend() || it->second.modified != modified)
+		return false;
+
+	entries = it->second.entries;
+	mScanned[path] = it->second;
+	return true;
+}
+
+void DirectoryScanCache::put(const std::string& path, long long modified, const std::vector<Entry>& entries)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	mChanged = true;
+
+	// a directory modified within the last couple of seconds could still change without its mtime moving
+	// (coarse timestamps on some filesystems), don't trust it and scan it again next time
+	if(modified == 0 || (modified / 1000000000LL) >= (long long)time(nullptr) - 2)
+		return;
+
+	// names containing a line break can't be represented in the cache file
+	for(auto it = entries.cbegin(); it != entries.cend(); ++it)
+	{
+		if(it->name.find_first_of("\r\n") != std::string::npos)
+			return;
+	}
+	if(path.find_first_of("\r\n") != std::string::npos)
+		return;
+
+	Directory& directory = mScanned[path];
+	directory.modified = modified;
+	directory.entries = entries;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef ES_APP_DIRECTORY_SCAN_CACHE_H
+#define ES_APP_DIRECTORY_SCAN_CACHE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Remembers, per directory of a system's rom folder, the entries populateFolder() kept (games and subfolders)
+// together with the directory modification time. A directory whose mtime didn't change since the cache was
+// written can be restored without listing it again, only changed directories have to be scanned.
+class DirectoryScanCache
+{
+public:
+	struct Entry
+	{
+		std::string name; // file name, relative to the directory
+		bool isGame;      // matched the system extensions, otherwise it's a subfolder
+	};
+
+	// signature describes everything the scan result depends on besides the filesystem (extensions, hidden files, ...),
+	// a cache written with a different signature is discarded
+	DirectoryScanCache(const std::string& path, const std::string& signature);
+
+	void load();
+	void save();
+
+	// get() and put() can be called from several threads while a system is scanned in parallel
+
+	// returns true and fills entries if path was cached with the same modification time
+	bool get(const std::string& path, long long modified, std::vector<Entry>& entries);
+	// records the result of a real scan of path
+	void put(const std::string& path, long long modified, const std::vector<Entry>& entries);
+
+private:
+	struct Directory
+	{
+		long long modified;
+		std::vector<Entry> entries;
+	};
+
+	std::string mPath;
+	std::string mSignature;
+	std::unordered_map<std::string, Directory> mCached;  // content of the cache file
+	std::unordered_map<std::string, Directory> mScanned; // directories visited by the current scan, written by save()
+	bool mChanged;
+	std::mutex mMutex;
+};
+
+#endif // ES_APP_DIRECTORY_SCAN_CACHE_H
@@ -0,0 +1,92 @@
+#include "ExtensionMatcher.h"
+
+static inline char toLowerAscii(char c)
+{
+	return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+}
+
+ExtensionMatcher::ExtensionMatcher() : mMask(0), mIgnoreCase(false)
+{
+}
+
+void ExtensionMatcher::setExtensions(const std::vector<std::string>& extensions, bool ignoreCase)
+{
+	mIgnoreCase = ignoreCase;
+
+	// keep the table at most half full so probing stays short
+	size_t size = 8;
+	while(size < extensions.size() * 2)
+		size *= 2;
+
+	mSlots.assign(size, std::string());
+	mMask = size - 1;
+
+	for(auto it = extensions.cbegin(); it != extensions.cend(); ++it)
+	{
+		if(it->empty())
+			continue;
+
+		size_t slot = hash(it->c_str(), it->length()) & mMask;
+		while(!mSlots[slot].empty() && !equals(mSlots[slot], it->c_str(), it->length()))
+			slot = (slot + 1) & mMask;
+
+		mSlots[slot] = *it;
+	}
+}
+
+bool ExtensionMatcher::matches(const std::string& fileName) const
+{
+	if(mSlots.empty())
+		return false;
+
+	// the extension starts at the last '.' of the file name, names without one have the extension "."
+	const char* extension = ".";
+	size_t length = 1;
+
+	const size_t separator = fileName.find_last_of('/');
+	const size_t nameStart = (separator == std::string::npos) ? 0 : separator + 1;
+	const size_t dot = fileName.find_last_of('.');
+	if((dot != std::string::npos) && (dot >= nameStart))
+	{
+		extension = fileName.c_str() + dot;
+		length = fileName.length() - dot;
+	}
+
+	size_t slot = hash(extension, length) & mMask;
+	while(!mSlots[slot].empty())
+	{
+		if(equals(mSlots[slot], extension, length))
+			return true;
+
+		slot = (slot + 1) & mMask;
+	}
+
+	return false;
+}
+
+size_t ExtensionMatcher::hash(const char* extension, size_t length) const
+{
+	// FNV-1a, folding case first when matching case insensitively
+	size_t value = 2166136261u;
+	for(size_t i = 0; i < length; ++i)
+	{
+		value ^= (unsigned char)(mIgnoreCase ? toLowerAscii(extension[i]) : extension[i]);
+		value *= 16777619u;
+	}
+
+	return value;
+}
+
+bool ExtensionMatcher::equals(const std::string& extension, const char* other, size_t length) const
+{
+	if(extension.length() != length)
+		return false;
+
+	for(size_t i = 0; i < length; ++i)
+	{
+		if(mIgnoreCase ? (toLowerAscii(extension[i]) != toLowerAscii(other[i])) : (extension[i] != other[i]))
+			return false;
+	}
+
+	return true;
+}
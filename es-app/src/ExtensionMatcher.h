@@ -0,0 +1,29 @@
+#pragma once
+#ifndef ES_APP_EXTENSION_MATCHER_H
+#define ES_APP_EXTENSION_MATCHER_H
+
+#include <string>
+#include <vector>
+
+// Matches file names against the extensions of a system. Built once when es_systems.cfg is loaded,
+// matching only hashes and compares the characters after the last '.' of the name, without allocating.
+class ExtensionMatcher
+{
+public:
+	ExtensionMatcher();
+
+	void setExtensions(const std::vector<std::string>& extensions, bool ignoreCase);
+	bool matches(const std::string& fileName) const; // same extension rules as Utils::FileSystem::getExtension
+
+	inline bool ignoresCase() const { return mIgnoreCase; }
+
+private:
+	size_t hash(const char* extension, size_t length) const;
+	bool equals(const std::string& extension, const char* other, size_t length) const;
+
+	std::vector<std::string> mSlots; // open addressing, empty strings are free slots
+	size_t mMask;
+	bool mIgnoreCase;
+};
+
+#endif // ES_APP_EXTENSION_MATCHER_H
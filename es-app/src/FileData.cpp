@@ -7,6 +7,7 @@
 #include "CollectionSystemManager.h"
 #include "FileFilterIndex.h"
 #include "FileSorts.h"
+#include "GameSearchIndex.h"
 #include "Log.h"
 #include "MameNames.h"
 #include "platform.h"
@@ -14,38 +15,45 @@
 #include "SystemData.h"
 #include "VolumeControl.h"
 #include "Window.h"
+#include <algorithm>
 #include <assert.h>
 
 FileData::FileData(FileType type, const std::string& path, SystemEnvironmentData* envData, SystemData* system)
-	: mType(type), mPath(path), mSystem(system), mEnvData(envData), mSourceFileData(NULL), mParent(NULL), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
+	: mType(type), mPath(path), mSystem(system), mEnvData(envData), mSourceFileData(NULL), mParent(NULL), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA), // metadata is REALLY set in the constructor!
+	mChildrenByFilename(ChildMap::allocator_type(FileDataArena::getArena(this))), mGameCount(type == GAME ? 1 : 0),
+	mFilteredIndex(nullptr), mFilteredGeneration(0), mFilteredMetaDataGeneration(0), mSortComparator(nullptr), mSortAscending(true)
 {
+	mDisplayName = Utils::FileSystem::getStem(mPath);
+	if(mSystem && mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO))
+		mDisplayName = MameNames::getInstance()->getRealName(mDisplayName);
+
 	// metadata needs at least a name field (since that's what getName() will return)
-	if(metadata.get("name").empty())
-		metadata.set("name", getDisplayName());
+	if(metadata.get(META_NAME).empty())
+		metadata.set(META_NAME, mDisplayName);
 	mSystemName = system->getName();
+	mSystemSortKey = &system->getSortKey();
 	metadata.resetChangedFlag();
 }
 
 FileData::~FileData()
 {
+	// the whole tree goes away with its system
+	if(FileDataArena::isReleasing(this))
+		return;
+
 	if(mParent)
 		mParent->removeChild(this);
 
 	if(mType == GAME)
+	{
 		mSystem->getIndex()->removeFromIndex(this);
+		if(mSystem->getSearchIndex())
+			mSystem->getSearchIndex()->removeGame(this);
+	}
 
 	mChildren.clear();
 }
 
-std::string FileData::getDisplayName() const
-{
-	std::string stem = Utils::FileSystem::getStem(mPath);
-	if(mSystem && mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO))
-		stem = MameNames::getInstance()->getRealName(stem);
-
-	return stem;
-}
-
 std::string FileData::getCleanName() const
 {
 	return Utils::String::removeParenthesis(this->getDisplayName());
@@ -53,12 +61,12 @@ std::string FileData::getCleanName() const
 
 const std::string FileData::getThumbnailPath() const
 {
-	std::string thumbnail = metadata.get("thumbnail");
+	std::string thumbnail = metadata.get(META_THUMBNAIL);
 
 	// no thumbnail, try image
 	if(thumbnail.empty())
 	{
-		thumbnail = metadata.get("image");
+		thumbnail = metadata.get(META_IMAGE);
 
 		// no image, try to use local image
 		if(thumbnail.empty() && Settings::getInstance()->getBool("LocalArt"))
@@ -67,11 +75,7 @@ const std::string FileData::getThumbnailPath() const
 			for(int i = 0; i < 2; i++)
 			{
 				if(thumbnail.empty())
-				{
-					std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-image" + extList[i];
-					if(Utils::FileSystem::exists(path))
-						thumbnail = path;
-				}
+					thumbnail = mEnvData->mLocalArt.find(getDisplayName() + "-image" + extList[i]);
 			}
 		}
 	}
@@ -81,27 +85,37 @@ const std::string FileData::getThumbnailPath() const
 
 const std::string& FileData::getName()
 {
-	return metadata.get("name");
+	return metadata.get(META_NAME);
 }
 
 const std::string& FileData::getSortName()
 {
-	if (metadata.get("sortname").empty())
-		return metadata.get("name");
+	if (metadata.get(META_SORTNAME).empty())
+		return metadata.get(META_NAME);
 	else
-		return metadata.get("sortname");
+		return metadata.get(META_SORTNAME);
 }
 
 const std::vector<FileData*>& FileData::getChildrenListToDisplay() {
 
 	FileFilterIndex* idx = CollectionSystemManager::get()->getSystemToView(mSystem)->getIndex();
 	if (idx->isFiltered()) {
-		mFilteredChildren.clear();
-		for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
+		// the generation is read first, an edit while the list is built makes it outdated right away. Games loaded or
+		// played elsewhere don't count, loaded games enter the index and play statistics aren't filtered by
+		const unsigned int metaDataGeneration = mSystem->getMetaDataGeneration();
+		if ((mFilteredIndex != idx) || (mFilteredGeneration != idx->getGeneration()) || (mFilteredMetaDataGeneration != metaDataGeneration))
 		{
-			if (idx->showFile((*it))) {
-				mFilteredChildren.push_back(*it);
+			mFilteredChildren.clear();
+			for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
+			{
+				if (idx->showFile((*it))) {
+					mFilteredChildren.push_back(*it);
+				}
 			}
+
+			mFilteredIndex = idx;
+			mFilteredGeneration = idx->getGeneration();
+			mFilteredMetaDataGeneration = metaDataGeneration;
 		}
 
 		return mFilteredChildren;
@@ -114,14 +128,12 @@ const std::vector<FileData*>& FileData::getChildrenListToDisplay() {
 
 const std::string FileData::getVideoPath() const
 {
-	std::string video = metadata.get("video");
+	std::string video = metadata.get(META_VIDEO);
 
 	// no video, try to use local video
 	if(video.empty() && Settings::getInstance()->getBool("LocalArt"))
 	{
-		std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-video.mp4";
-		if(Utils::FileSystem::exists(path))
-			video = path;
+		video = mEnvData->mLocalArt.find(getDisplayName() + "-video.mp4");
 	}
 
 	return video;
@@ -129,7 +141,7 @@ const std::string FileData::getVideoPath() const
 
 const std::string FileData::getMarqueePath() const
 {
-	std::string marquee = metadata.get("marquee");
+	std::string marquee = metadata.get(META_MARQUEE);
 
 	// no marquee, try to use local marquee
 	if(marquee.empty() && Settings::getInstance()->getBool("LocalArt"))
@@ -138,11 +150,7 @@ const std::string FileData::getMarqueePath() const
 		for(int i = 0; i < 2; i++)
 		{
 			if(marquee.empty())
-			{
-				std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-marquee" + extList[i];
-				if(Utils::FileSystem::exists(path))
-					marquee = path;
-			}
+				marquee = mEnvData->mLocalArt.find(getDisplayName() + "-marquee" + extList[i]);
 		}
 	}
 
@@ -151,7 +159,7 @@ const std::string FileData::getMarqueePath() const
 
 const std::string FileData::getImagePath() const
 {
-	std::string image = metadata.get("image");
+	std::string image = metadata.get(META_IMAGE);
 
 	// no image, try to use local image
 	if(image.empty())
@@ -160,38 +168,31 @@ const std::string FileData::getImagePath() const
 		for(int i = 0; i < 2; i++)
 		{
 			if(image.empty())
-			{
-				std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-image" + extList[i];
-				if(Utils::FileSystem::exists(path))
-					image = path;
-			}
+				image = mEnvData->mLocalArt.find(getDisplayName() + "-image" + extList[i]);
 		}
 	}
 
 	return image;
 }
 
-std::vector<FileData*> FileData::getFilesRecursive(unsigned int typeMask, bool displayedOnly) const
+bool FileData::visitFilesRecursive(unsigned int typeMask, bool displayedOnly, const std::function<bool(FileData*)>& visitor) const
 {
-	std::vector<FileData*> out;
 	FileFilterIndex* idx = mSystem->getIndex();
+	const bool filtered = displayedOnly && idx->isFiltered();
 
 	for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
 	{
-		if((*it)->getType() & typeMask)
+		if(((*it)->getType() & typeMask) && (!filtered || idx->showFile(*it)))
 		{
-			if (!displayedOnly || !idx->isFiltered() || idx->showFile(*it))
-				out.push_back(*it);
+			if(!visitor(*it))
+				return false;
 		}
 
-		if((*it)->getChildren().size() > 0)
-		{
-			std::vector<FileData*> subchildren = (*it)->getFilesRecursive(typeMask, displayedOnly);
-			out.insert(out.cend(), subchildren.cbegin(), subchildren.cend());
-		}
+		if(!(*it)->mChildren.empty() && !(*it)->visitFilesRecursive(typeMask, displayedOnly, visitor))
+			return false;
 	}
 
-	return out;
+	return true;
 }
 
 std::string FileData::getKey() {
@@ -222,8 +223,13 @@ void FileData::addChild(FileData* file)
 	if (mChildrenByFilename.find(key) == mChildrenByFilename.cend())
 	{
 		mChildrenByFilename[key] = file;
-		mChildren.push_back(file);
+		if(mSortComparator)
+			mChildren.insert(findSortPosition(file), file);
+		else
+			mChildren.push_back(file);
 		file->mParent = this;
+
+		onStructureChanged((int)file->mGameCount);
 	}
 }
 
@@ -232,14 +238,15 @@ void FileData::removeChild(FileData* file)
 	assert(mType == FOLDER);
 	assert(file->getParent() == this);
 	mChildrenByFilename.erase(file->getKey());
-	for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
+
+	auto it = std::find(mChildren.begin(), mChildren.end(), file);
+	if(it != mChildren.end())
 	{
-		if(*it == file)
-		{
-			file->mParent = NULL;
-			mChildren.erase(it);
-			return;
-		}
+		file->mParent = NULL;
+		mChildren.erase(it);
+
+		onStructureChanged(-(int)file->mGameCount);
+		return;
 	}
 
 	// File somehow wasn't in our children.
@@ -247,18 +254,82 @@ void FileData::removeChild(FileData* file)
 
 }
 
+void FileData::repositionChild(FileData* file)
+{
+	assert(file->getParent() == this);
+	if(!mSortComparator)
+		return;
+
+	auto it = std::find(mChildren.begin(), mChildren.end(), file);
+	if(it == mChildren.end())
+		return;
+
+	// nothing moves as long as it still sorts between its neighbours
+	ComparisonFunction* comparator = mSortComparator;
+	const bool ascending = mSortAscending;
+	auto inOrder = [comparator, ascending](const FileData* a, const FileData* b) { return ascending ? !comparator(b, a) : !comparator(a, b); };
+	if(((it == mChildren.begin()) || inOrder(*(it - 1), file)) && ((it + 1 == mChildren.end()) || inOrder(file, *(it + 1))))
+		return;
+
+	mChildren.erase(it);
+	mChildren.insert(findSortPosition(file), file);
+
+	onStructureChanged(0);
+}
+
+std::vector<FileData*>::iterator FileData::findSortPosition(FileData* file)
+{
+	ComparisonFunction* comparator = mSortComparator;
+
+	// a descending list is an ascending one reversed, files that sort equal end up in reverse order too
+	if(mSortAscending)
+		return std::upper_bound(mChildren.begin(), mChildren.end(), file, comparator);
+	else
+		return std::lower_bound(mChildren.begin(), mChildren.end(), file, [comparator](const FileData* child, const FileData* value) { return comparator(value, child); });
+}
+
+bool FileData::isSortedBy(ComparisonFunction& comparator, bool ascending) const
+{
+	if((mSortComparator != &comparator) || (mSortAscending != ascending))
+		return false;
+
+	// a game whose metadata changed without repositionChild() leaves its folder out of order
+	if(ascending)
+		return std::is_sorted(mChildren.cbegin(), mChildren.cend(), comparator);
+	else
+		return std::is_sorted(mChildren.crbegin(), mChildren.crend(), comparator);
+}
+
+void FileData::onStructureChanged(int gameCountDelta)
+{
+	for(FileData* folder = this; folder; folder = folder->mParent)
+	{
+		folder->mGameCount += gameCountDelta;
+		folder->mFilteredIndex = nullptr; // a folder is shown if any game below it is
+		folder->mSystem->invalidateGames();
+	}
+}
+
 void FileData::sort(ComparisonFunction& comparator, bool ascending)
 {
-	std::stable_sort(mChildren.begin(), mChildren.end(), comparator);
+	if(!isSortedBy(comparator, ascending))
+	{
+		onStructureChanged(0);
+
+		std::stable_sort(mChildren.begin(), mChildren.end(), comparator);
+
+		if(!ascending)
+			std::reverse(mChildren.begin(), mChildren.end());
+
+		mSortComparator = &comparator;
+		mSortAscending = ascending;
+	}
 
 	for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
 	{
 		if((*it)->getChildren().size() > 0)
 			(*it)->sort(comparator, ascending);
 	}
-
-	if(!ascending)
-		std::reverse(mChildren.begin(), mChildren.end());
 }
 
 void FileData::sort(const SortType& type)
@@ -304,14 +375,14 @@ void FileData::launchGame(Window* window)
 
 	FileData* gameToUpdate = getSourceFileData();
 
-	int timesPlayed = gameToUpdate->metadata.getInt("playcount") + 1;
-	gameToUpdate->metadata.set("playcount", std::to_string(static_cast<long long>(timesPlayed)));
+	int timesPlayed = gameToUpdate->metadata.getInt(META_PLAYCOUNT) + 1;
+	gameToUpdate->metadata.set(META_PLAYCOUNT, std::to_string(static_cast<long long>(timesPlayed)));
 
 	//update last played time
-	gameToUpdate->metadata.set("lastplayed", Utils::Time::DateTime(Utils::Time::now()));
+	gameToUpdate->metadata.set(META_LASTPLAYED, Utils::Time::DateTime(Utils::Time::now()));
 	CollectionSystemManager::get()->refreshCollectionSystems(gameToUpdate);
 
-	gameToUpdate->mSystem->onMetaDataSavePoint();
+	gameToUpdate->mSystem->onStatisticsSavePoint(gameToUpdate);
 }
 
 CollectionFileData::CollectionFileData(FileData* file, SystemData* system)
@@ -323,12 +394,14 @@ CollectionFileData::CollectionFileData(FileData* file, SystemData* system)
 	mParent = NULL;
 	metadata = mSourceFileData->metadata;
 	mSystemName = mSourceFileData->getSystem()->getName();
+	mSystemSortKey = &mSourceFileData->getSystemSortKey();
+	mDisplayName = mSourceFileData->getDisplayName();
 }
 
 CollectionFileData::~CollectionFileData()
 {
 	// need to remove collection file data at the collection object destructor
-	if(mParent)
+	if(mParent && !FileDataArena::isReleasing(this))
 		mParent->removeChild(this);
 	mParent = NULL;
 }
@@ -351,14 +424,14 @@ void CollectionFileData::refreshMetadata()
 const std::string& CollectionFileData::getName()
 {
 	if (mDirty) {
-		mCollectionFileName = Utils::String::removeParenthesis(mSourceFileData->metadata.get("name"));
+		mCollectionFileName = Utils::String::removeParenthesis(mSourceFileData->metadata.get(META_NAME));
 		mCollectionFileName += " [" + Utils::String::toUpper(mSourceFileData->getSystem()->getName()) + "]";
 		mDirty = false;
 	}
 
 	if (Settings::getInstance()->getBool("CollectionShowSystemInfo"))
 		return mCollectionFileName;
-	return mSourceFileData->metadata.get("name");
+	return mSourceFileData->metadata.get(META_NAME);
 }
 
 // returns Sort Type based on a string description
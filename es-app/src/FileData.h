@@ -3,7 +3,10 @@
 #define ES_APP_FILE_DATA_H
 
 #include "utils/FileSystemUtil.h"
+#include "FileDataArena.h"
+#include "FileFilterIndex.h"
 #include "MetaData.h"
+#include <functional>
 #include <unordered_map>
 
 class SystemData;
@@ -30,31 +33,44 @@ const char* fileTypeToString(FileType type);
 FileType stringToFileType(const char* str);
 
 // A tree node that holds information for a file.
+// The nodes of a system are created in its arena with new (system->getArena()), a plain new puts one on the heap.
 class FileData
 {
 public:
+	typedef std::unordered_map<std::string, FileData*, std::hash<std::string>, std::equal_to<std::string>, FileDataArena::Allocator<std::pair<const std::string, FileData*>>> ChildMap;
+
 	FileData(FileType type, const std::string& path, SystemEnvironmentData* envData, SystemData* system);
 	virtual ~FileData();
 
+	static void* operator new(size_t size) { return FileDataArena::allocateNode(nullptr, size); }
+	static void* operator new(size_t size, FileDataArena* arena) { return FileDataArena::allocateNode(arena, size); }
+	static void operator delete(void* ptr) { FileDataArena::freeNode(ptr); }
+	static void operator delete(void* ptr, FileDataArena* /*arena*/) { FileDataArena::freeNode(ptr); }
+
 	virtual const std::string& getName();
 	virtual const std::string& getSortName();
 	inline FileType getType() const { return mType; }
 	inline const std::string& getPath() const { return mPath; }
 	inline FileData* getParent() const { return mParent; }
-	inline const std::unordered_map<std::string, FileData*>& getChildrenByFilename() const { return mChildrenByFilename; }
+	inline const ChildMap& getChildrenByFilename() const { return mChildrenByFilename; }
 	inline const std::vector<FileData*>& getChildren() const { return mChildren; }
+	inline unsigned int getGameCount() const { return mGameCount; } // games in this subtree, kept up to date by addChild and removeChild
 	inline SystemData* getSystem() const { return mSystem; }
 	inline SystemEnvironmentData* getSystemEnvData() const { return mEnvData; }
+	inline FilterKeys& getFilterKeys() { return mFilterKeys; } // maintained by FileFilterIndex
 	virtual const std::string getThumbnailPath() const;
 	virtual const std::string getVideoPath() const;
 	virtual const std::string getMarqueePath() const;
 	virtual const std::string getImagePath() const;
 
 	const std::vector<FileData*>& getChildrenListToDisplay();
-	std::vector<FileData*> getFilesRecursive(unsigned int typeMask, bool displayedOnly = false) const;
+	// Calls visitor for every node below this one whose type is in typeMask, depth first in tree order, without
+	// building any list. Stops as soon as visitor returns false and returns false then. The tree must not change meanwhile.
+	bool visitFilesRecursive(unsigned int typeMask, bool displayedOnly, const std::function<bool(FileData*)>& visitor) const;
 
-	void addChild(FileData* file); // Error if mType != FOLDER
+	void addChild(FileData* file); // Error if mType != FOLDER, inserted at its place once the children were sorted
 	void removeChild(FileData* file); //Error if mType != FOLDER
+	void repositionChild(FileData* file); // moves file back to its place in the sort order after its metadata changed
 
 	inline bool isPlaceHolder() { return mType == PLACEHOLDER; };
 
@@ -66,9 +82,11 @@ public:
 	inline std::string getFileName() { return Utils::FileSystem::getFileName(getPath()); };
 	virtual FileData* getSourceFileData();
 	inline std::string getSystemName() const { return mSystemName; };
+	inline const std::string& getSystemSortKey() const { return *mSystemSortKey; } // upper-cased system name
 
 	// Returns our best guess at the "real" name for this file (will attempt to perform MAME name translation)
-	std::string getDisplayName() const;
+	// Worked out once when the node is created.
+	inline const std::string& getDisplayName() const { return mDisplayName; }
 
 	// As above, but also remove parenthesis
 	std::string getCleanName() const;
@@ -86,23 +104,38 @@ public:
 			: comparisonFunction(sortFunction), ascending(sortAscending), description(sortDescription) {}
 	};
 
+	// only sorts again if the sort changed or the children got out of order, checking that takes a single pass
 	void sort(ComparisonFunction& comparator, bool ascending = true);
 	void sort(const SortType& type);
 	MetaDataList metadata;
 
+private:
+	bool isSortedBy(ComparisonFunction& comparator, bool ascending) const;
+	std::vector<FileData*>::iterator findSortPosition(FileData* file); // where file goes in mChildren, after the children that sort equal
+	void onStructureChanged(int gameCountDelta); // updates the game counts and flat game lists of this folder and its parents
+
 protected:
 	FileData* mSourceFileData;
 	FileData* mParent;
 	std::string mSystemName;
+	const std::string* mSystemSortKey; // the one of the system, see SystemData::getSortKey
+	std::string mDisplayName;
 
 private:
 	FileType mType;
 	std::string mPath;
 	SystemEnvironmentData* mEnvData;
 	SystemData* mSystem;
-	std::unordered_map<std::string,FileData*> mChildrenByFilename;
+	ChildMap mChildrenByFilename;
 	std::vector<FileData*> mChildren;
-	std::vector<FileData*> mFilteredChildren;
+	std::vector<FileData*> mFilteredChildren; // kept until the filters, the indexed games, the children or the games of the system were edited
+	const FileFilterIndex* mFilteredIndex; // mFilteredChildren was built for, nullptr once the children changed
+	unsigned int mFilteredGeneration; // of mFilteredIndex
+	unsigned int mFilteredMetaDataGeneration; // of mSystem, see SystemData::getMetaDataGeneration
+	ComparisonFunction* mSortComparator; // the children were last sorted by, nullptr if they never were
+	bool mSortAscending;
+	unsigned int mGameCount;
+	FilterKeys mFilterKeys;
 };
 
 class CollectionFileData : public FileData
@@ -0,0 +1,127 @@
+#include "FileDataArena.h"
+
+#include "FileData.h"
+#include <stdlib.h>
+
+FileDataArena::FileDataArena() : mReleasing(false)
+{
+}
+
+FileDataArena::~FileDataArena()
+{
+	mReleasing = true;
+
+	// walk the blocks slot by slot, the nodes still alive are destroyed in place and their containers
+	// don't bother handing their slots back, the blocks go away as a whole right after
+	for(auto it = mBlocks.cbegin(); it != mBlocks.cend(); ++it)
+	{
+		size_t offset = 0;
+		while(offset < it->used)
+		{
+			Header* header = (Header*)(it->data + offset);
+			if(header->kind == NODE)
+				((FileData*)getSlot(header))->~FileData();
+
+			offset += HEADER_SIZE + header->size;
+		}
+	}
+
+	for(auto it = mBlocks.cbegin(); it != mBlocks.cend(); ++it)
+		free(it->data);
+}
+
+void* FileDataArena::allocateNode(FileDataArena* arena, size_t size)
+{
+	if(arena)
+		return arena->allocate(size, NODE);
+
+	Header* header = (Header*)malloc(HEADER_SIZE + size);
+	if(!header)
+		throw std::bad_alloc();
+
+	header->arena = nullptr;
+	header->size = (uint32_t)size;
+	header->kind = NODE;
+	return getSlot(header);
+}
+
+void FileDataArena::freeNode(void* node)
+{
+	if(!node)
+		return;
+
+	Header* header = getHeader(node);
+	if(header->arena)
+		header->arena->release(node);
+	else
+		free(header);
+}
+
+FileDataArena* FileDataArena::getArena(const void* node)
+{
+	return getHeader(node)->arena;
+}
+
+bool FileDataArena::isReleasing(const void* node)
+{
+	FileDataArena* arena = getHeader(node)->arena;
+	return arena && arena->mReleasing;
+}
+
+void* FileDataArena::allocate(size_t size, SlotKind kind)
+{
+	size = (size + 15) & ~(size_t)15;
+	const size_t index = size / 16;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	// reuse a slot of the same size first
+	if((index < mFreeSlots.size()) && mFreeSlots[index])
+	{
+		Header* header = mFreeSlots[index];
+		mFreeSlots[index] = *(Header**)getSlot(header);
+		header->kind = kind;
+		return getSlot(header);
+	}
+
+	const size_t needed = HEADER_SIZE + size;
+	if(mBlocks.empty() || (mBlocks.back().size - mBlocks.back().used < needed))
+	{
+		// the rest of the previous block is left unused, a node bigger than a block gets a block of its own
+		Block block;
+		block.size = (needed > BLOCK_SIZE) ? needed : BLOCK_SIZE;
+		block.used = 0;
+		block.data = (char*)malloc(block.size);
+		if(!block.data)
+			throw std::bad_alloc();
+
+		mBlocks.push_back(block);
+	}
+
+	Block& block = mBlocks.back();
+	Header* header = (Header*)(block.data + block.used);
+	block.used += needed;
+
+	header->arena = this;
+	header->size = (uint32_t)size;
+	header->kind = kind;
+	return getSlot(header);
+}
+
+void FileDataArena::release(void* ptr)
+{
+	if(mReleasing)
+		return;
+
+	Header* header = getHeader(ptr);
+	const size_t index = header->size / 16;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	if(index >= mFreeSlots.size())
+		mFreeSlots.resize(index + 1, nullptr);
+
+	header->kind = FREE;
+	*(Header**)ptr = mFreeSlots[index];
+	mFreeSlots[index] = header;
+}
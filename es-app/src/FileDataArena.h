@@ -0,0 +1,104 @@
+#pragma once
+#ifndef ES_APP_FILE_DATA_ARENA_H
+#define ES_APP_FILE_DATA_ARENA_H
+
+#include <mutex>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Holds the FileData nodes of one system and the maps of their children. Memory is cut from large blocks
+// so a tree ends up close together, nodes deleted one by one are recycled for nodes of the same size.
+// Deleting the arena destroys the nodes that are still alive without unlinking them from their parents
+// or their filter index, and hands the blocks back at once. Thread safe, folders are scanned in parallel.
+class FileDataArena
+{
+public:
+	FileDataArena();
+	~FileDataArena();
+
+	// FileData::operator new and delete, without an arena the node lives on the heap
+	static void* allocateNode(FileDataArena* arena, size_t size);
+	static void  freeNode(void* node);
+
+	static FileDataArena* getArena(const void* node); // nullptr for nodes on the heap
+	static bool isReleasing(const void* node); // true while the arena of node is being deleted
+
+	// for the containers of the nodes, only small allocations (hash nodes) come from the blocks
+	template<typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator(FileDataArena* arena) : mArena(arena) { }
+		template<typename U> Allocator(const Allocator<U>& other) : mArena(other.getArena()) { }
+
+		T* allocate(size_t count)
+		{
+			const size_t size = count * sizeof(T);
+			if(!mArena || (size > MAX_CONTAINER_SIZE))
+				return (T*)::operator new(size);
+
+			return (T*)mArena->allocate(size, RAW);
+		}
+
+		void deallocate(T* ptr, size_t count)
+		{
+			const size_t size = count * sizeof(T);
+			if(!mArena || (size > MAX_CONTAINER_SIZE))
+				::operator delete(ptr);
+			else
+				mArena->release(ptr);
+		}
+
+		inline FileDataArena* getArena() const { return mArena; }
+
+		template<typename U> bool operator==(const Allocator<U>& other) const { return mArena == other.getArena(); }
+		template<typename U> bool operator!=(const Allocator<U>& other) const { return mArena != other.getArena(); }
+
+	private:
+		FileDataArena* mArena;
+	};
+
+private:
+	enum SlotKind
+	{
+		FREE = 0,
+		RAW  = 1,
+		NODE = 2
+	};
+
+	// in front of every allocation, padded to 16 bytes so the allocations stay aligned like malloc's
+	struct Header
+	{
+		FileDataArena* arena;
+		uint32_t size; // of the slot after the header
+		uint32_t kind;
+	};
+
+	struct Block
+	{
+		char* data;
+		size_t size;
+		size_t used;
+	};
+
+	static const size_t HEADER_SIZE = 16;
+	static const size_t BLOCK_SIZE = 64 * 1024;
+	static const size_t MAX_CONTAINER_SIZE = 256;
+
+	static inline Header* getHeader(const void* ptr) { return (Header*)((char*)ptr - HEADER_SIZE); }
+	static inline void* getSlot(Header* header) { return (char*)header + HEADER_SIZE; }
+
+	void* allocate(size_t size, SlotKind kind);
+	void release(void* ptr);
+
+	std::mutex mMutex;
+	std::vector<Block> mBlocks;
+	std::vector<Header*> mFreeSlots; // one list per slot size in 16 byte steps, linked through the slots
+	bool mReleasing;
+};
+
+#endif // ES_APP_FILE_DATA_ARENA_H
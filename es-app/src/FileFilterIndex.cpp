@@ -9,8 +9,14 @@
 #define UNKNOWN_LABEL "UNKNOWN"
 #define INCLUDE_UNKNOWN false;
 
+// the secondary key id of games without one, no filter holds it
+#define NO_KEY_ID 0xFFFFFFFFu
+
+std::unordered_map<std::string, unsigned int> FileFilterIndex::sKeyIds;
+std::mutex FileFilterIndex::sKeyIdsMutex;
+
 FileFilterIndex::FileFilterIndex()
-	: filterByFavorites(false), filterByGenre(false), filterByHidden(false), filterByKidGame(false), filterByPlayers(false), filterByPubDev(false), filterByRatings(false)
+	: filterByFavorites(false), filterByGenre(false), filterByHidden(false), filterByKidGame(false), filterByPlayers(false), filterByPubDev(false), filterByRatings(false), mGeneration(0)
 {
 	clearAllFilters();
 	FilterDataDecl filterDecls[] = {
@@ -39,6 +45,8 @@ std::vector<FilterDataDecl>& FileFilterIndex::getFilterDataDecls()
 
 void FileFilterIndex::importIndex(FileFilterIndex* indexToImport)
 {
+	++mGeneration;
+
 	struct IndexImportStructure
 	{
 		std::map<std::string, int>* destinationIndex;
@@ -92,7 +100,7 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 	{
 		case GENRE_FILTER:
 		{
-			key = Utils::String::toUpper(game->metadata.get("genre"));
+			key = Utils::String::toUpper(game->metadata.get(META_GENRE));
 			key = Utils::String::trim(key);
 			if (getSecondary && !key.empty()) {
 				std::istringstream f(key);
@@ -114,18 +122,18 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 			if (getSecondary)
 				break;
 
-			key = game->metadata.get("players");
+			key = game->metadata.get(META_PLAYERS);
 			break;
 		}
 		case PUBDEV_FILTER:
 		{
-			key = Utils::String::toUpper(game->metadata.get("publisher"));
+			key = Utils::String::toUpper(game->metadata.get(META_PUBLISHER));
 			key = Utils::String::trim(key);
 
 			if ((getSecondary && !key.empty()) || (!getSecondary && key.empty()))
-				key = Utils::String::toUpper(game->metadata.get("developer"));
+				key = Utils::String::toUpper(game->metadata.get(META_DEVELOPER));
 			else
-				key = Utils::String::toUpper(game->metadata.get("publisher"));
+				key = Utils::String::toUpper(game->metadata.get(META_PUBLISHER));
 			break;
 		}
 		case RATINGS_FILTER:
@@ -133,7 +141,7 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 			int ratingNumber = 0;
 			if (!getSecondary)
 			{
-				std::string ratingString = game->metadata.get("rating");
+				std::string ratingString = game->metadata.get(META_RATING);
 				if (!ratingString.empty()) {
 					try {
 						ratingNumber = (int)((std::stod(ratingString)*5)+0.5);
@@ -154,21 +162,21 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 		{
 			if (game->getType() != GAME)
 				return "FALSE";
-			key = Utils::String::toUpper(game->metadata.get("favorite"));
+			key = Utils::String::toUpper(game->metadata.get(META_FAVORITE));
 			break;
 		}
 		case HIDDEN_FILTER:
 		{
 			if (game->getType() != GAME)
 				return "FALSE";
-			key = Utils::String::toUpper(game->metadata.get("hidden"));
+			key = Utils::String::toUpper(game->metadata.get(META_HIDDEN));
 			break;
 		}
 		case KIDGAME_FILTER:
 		{
 			if (game->getType() != GAME)
 				return "FALSE";
-			key = Utils::String::toUpper(game->metadata.get("kidgame"));
+			key = Utils::String::toUpper(game->metadata.get(META_KIDGAME));
 			break;
 		}
 	}
@@ -179,8 +187,56 @@ std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType typ
 	return key;
 }
 
+unsigned int FileFilterIndex::getKeyId(const std::string& key)
+{
+	std::unique_lock<std::mutex> lock(sKeyIdsMutex);
+	return sKeyIds.emplace(key, (unsigned int)sKeyIds.size()).first->second;
+}
+
+void FileFilterIndex::updateFilterKeys(FileData* game)
+{
+	FilterKeys& keys = game->getFilterKeys();
+	const unsigned int unknown = getKeyId(UNKNOWN_LABEL);
+
+	for (int type = 0; type < FILTER_TYPE_COUNT; ++type)
+	{
+		keys.primary[type] = unknown;
+		keys.secondary[type] = NO_KEY_ID;
+	}
+
+	for (std::vector<FilterDataDecl>::const_iterator it = filterDataDecl.cbegin(); it != filterDataDecl.cend(); ++it )
+	{
+		keys.primary[it->type] = getKeyId(getIndexableKey(game, it->type, false));
+		if (it->hasSecondaryKey)
+		{
+			// an unknown secondary key never matches, "UNKNOWN" only finds the games without a primary one
+			const unsigned int secondary = getKeyId(getIndexableKey(game, it->type, true));
+			keys.secondary[it->type] = (secondary != unknown) ? secondary : NO_KEY_ID;
+		}
+	}
+
+	keys.revision = game->metadata.getRevision();
+}
+
+void FileFilterIndex::compileFilter(const FilterDataDecl& filterData)
+{
+	std::vector<bool>& bits = mFilteredKeyIds[filterData.type];
+	bits.clear();
+
+	for (std::vector<std::string>::const_iterator it = filterData.currentFilteredKeys->cbegin(); it != filterData.currentFilteredKeys->cend(); ++it )
+	{
+		const unsigned int id = getKeyId(*it);
+		if (id >= bits.size())
+			bits.resize(id + 1, false);
+		bits[id] = true;
+	}
+}
+
 void FileFilterIndex::addToIndex(FileData* game)
 {
+	++mGeneration;
+	if (game->getFilterKeys().revision != game->metadata.getRevision())
+		updateFilterKeys(game);
 	manageGenreEntryInIndex(game);
 	managePlayerEntryInIndex(game);
 	managePubDevEntryInIndex(game);
@@ -192,6 +248,7 @@ void FileFilterIndex::addToIndex(FileData* game)
 
 void FileFilterIndex::removeFromIndex(FileData* game)
 {
+	++mGeneration;
 	manageGenreEntryInIndex(game, true);
 	managePlayerEntryInIndex(game, true);
 	managePubDevEntryInIndex(game, true);
@@ -203,6 +260,8 @@ void FileFilterIndex::removeFromIndex(FileData* game)
 
 void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>* values)
 {
+	++mGeneration;
+
 	// test if it exists before setting
 	if(type == NONE)
 	{
@@ -222,6 +281,7 @@ void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>*
 						filterData.currentFilteredKeys->push_back(std::string(*vit));
 					}
 				}
+				compileFilter(filterData);
 			}
 		}
 	}
@@ -230,11 +290,14 @@ void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>*
 
 void FileFilterIndex::clearAllFilters()
 {
+	++mGeneration;
+
 	for (std::vector<FilterDataDecl>::const_iterator it = filterDataDecl.cbegin(); it != filterDataDecl.cend(); ++it )
 	{
 		FilterDataDecl filterData = (*it);
 		*(filterData.filteredByRef) = false;
 		filterData.currentFilteredKeys->clear();
+		mFilteredKeyIds[filterData.type].clear();
 	}
 	return;
 }
@@ -298,7 +361,7 @@ bool FileFilterIndex::showFile(FileData* game)
 	// if folder, needs further inspection - i.e. see if folder contains at least one element
 	// that should be shown
 	if (game->getType() == FOLDER) {
-		std::vector<FileData*> children = game->getChildren();
+		const std::vector<FileData*>& children = game->getChildren();
 		// iterate through all of the children, until there's a match
 
 		for (std::vector<FileData*>::const_iterator it = children.cbegin(); it != children.cend(); ++it ) {
@@ -310,35 +373,23 @@ bool FileFilterIndex::showFile(FileData* game)
 		return false;
 	}
 
+	// the keys are only built again if the metadata changed since they were last used
+	const FilterKeys& keys = game->getFilterKeys();
+	if (keys.revision != game->metadata.getRevision())
+		updateFilterKeys(game);
+
 	bool keepGoing = false;
 
 	for (std::vector<FilterDataDecl>::const_iterator it = filterDataDecl.cbegin(); it != filterDataDecl.cend(); ++it ) {
-		FilterDataDecl filterData = (*it);
-		if(*(filterData.filteredByRef))
+		if(*(it->filteredByRef))
 		{
-			// try to find a match
-			std::string key = getIndexableKey(game, filterData.type, false);
-			keepGoing = isKeyBeingFilteredBy(key, filterData.type);
+			// try to find a match, then try for secondary keys - i.e. publisher and dev, or first genre
+			keepGoing = isKeyIdFiltered(it->type, keys.primary[it->type]) || (it->hasSecondaryKey && isKeyIdFiltered(it->type, keys.secondary[it->type]));
 
-			// if we didn't find a match, try for secondary keys - i.e. publisher and dev, or first genre
-			if (!keepGoing)
-			{
-				if (!filterData.hasSecondaryKey)
-				{
-					return false;
-				}
-				std::string secKey = getIndexableKey(game, filterData.type, true);
-				if (secKey != UNKNOWN_LABEL)
-				{
-					keepGoing = isKeyBeingFilteredBy(secKey, filterData.type);
-				}
-			}
 			// if still nothing, then it's not a match
 			if (!keepGoing)
 				return false;
-
 		}
-
 	}
 
 	return keepGoing;
@@ -3,8 +3,10 @@
 #define ES_APP_FILE_FILTER_INDEX_H
 
 #include <map>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 class FileData;
 
@@ -20,6 +22,19 @@ enum FilterIndexType
 	KIDGAME_FILTER
 };
 
+static const int FILTER_TYPE_COUNT = KIDGAME_FILTER + 1;
+
+// The keys of a game for every filter type as ids, see FileFilterIndex::getKeyId. Kept in the game and only
+// worked out again once its metadata changed, so showFile doesn't need to build any string.
+struct FilterKeys
+{
+	FilterKeys() : revision(0) { }
+
+	unsigned int revision; // of the metadata the ids were made of, 0 until they are
+	unsigned int primary[FILTER_TYPE_COUNT]; // by FilterIndexType
+	unsigned int secondary[FILTER_TYPE_COUNT]; // only for the types with a secondary key that isn't unknown, an id no filter holds otherwise
+};
+
 struct FilterDataDecl
 {
 	FilterIndexType type; // type of filter
@@ -45,7 +60,9 @@ public:
 	bool showFile(FileData* game);
 	bool isFiltered() { return (filterByGenre || filterByPlayers || filterByPubDev || filterByRatings || filterByFavorites || filterByHidden || filterByKidGame); };
 	bool isKeyBeingFilteredBy(std::string key, FilterIndexType type);
+	static unsigned int getKeyId(const std::string& key); // the same for every index, new keys get the next id
 	std::vector<FilterDataDecl>& getFilterDataDecls();
+	inline unsigned int getGeneration() const { return mGeneration; } // changes whenever a filter or an indexed game changes
 
 	void importIndex(FileFilterIndex* indexToImport);
 	void resetIndex();
@@ -55,6 +72,9 @@ public:
 private:
 	std::vector<FilterDataDecl> filterDataDecl;
 	std::string getIndexableKey(FileData* game, FilterIndexType type, bool getSecondary);
+	void updateFilterKeys(FileData* game);
+	void compileFilter(const FilterDataDecl& filterData);
+	inline bool isKeyIdFiltered(FilterIndexType type, unsigned int id) const { return (id < mFilteredKeyIds[type].size()) && mFilteredKeyIds[type][id]; }
 
 	void manageGenreEntryInIndex(FileData* game, bool remove = false);
 	void managePlayerEntryInIndex(FileData* game, bool remove = false);
@@ -92,7 +112,14 @@ private:
 	std::vector<std::string> hiddenIndexFilteredKeys;
 	std::vector<std::string> kidGameIndexFilteredKeys;
 
+	// the filtered keys above as one bit per key id, set by setFilter
+	std::vector<bool> mFilteredKeyIds[FILTER_TYPE_COUNT];
+
 	FileData* mRootFolder;
+	unsigned int mGeneration;
+
+	static std::unordered_map<std::string, unsigned int> sKeyIds;
+	static std::mutex sKeyIdsMutex;
 
 };
 
@@ -0,0 +1,275 @@
+#include "GameSearchIndex.h"
+
+#include "FileData.h"
+#include "Log.h"
+#include "SystemData.h"
+#include <algorithm>
+#include <chrono>
+
+// the fields a game is found by
+static const MetaDataId sSearchedFields[] = { META_NAME, META_SORTNAME, META_DEVELOPER, META_PUBLISHER, META_DESC };
+
+// games indexed between two looks at the clock
+#define GAMES_PER_CLOCK_CHECK 32
+
+// the index is built again from scratch once more games are dead than alive, but not for a handful of them
+#define MIN_DEAD_DOCUMENTS 1024
+
+GameSearchIndex::GameSearchIndex(SystemData* system) : mSystem(system), mDeadDocuments(0), mStamp(0), mPassRunning(false), mPassCursor(0), mPass(0),
+	mPassMetaDataGeneration(0), mPassGeneration(0), mIndexed(false), mIndexedMetaDataGeneration(0), mIndexedGeneration(0)
+{
+}
+
+void GameSearchIndex::getWords(const std::string& text, std::vector<std::string>& words)
+{
+	std::string word;
+	for(auto it = text.cbegin(); it != text.cend(); ++it)
+	{
+		const unsigned char c = (unsigned char)*it;
+		if((c >= 'A') && (c <= 'Z'))
+			word += (char)(c - 'A' + 'a');
+		else if(((c >= 'a') && (c <= 'z')) || ((c >= '0') && (c <= '9')) || (c >= 0x80))
+			word += (char)c;
+		else if(!word.empty())
+		{
+			words.push_back(word);
+			word.clear();
+		}
+	}
+
+	if(!word.empty())
+		words.push_back(word);
+}
+
+bool GameSearchIndex::isUpToDate() const
+{
+	return mIndexed && !mPassRunning && mSystem->isGameListLoaded()
+		&& (mSystem->getMetaDataGeneration() == mIndexedMetaDataGeneration) && (mSystem->getGamesGeneration() == mIndexedGeneration);
+}
+
+bool GameSearchIndex::update(int budgetMs)
+{
+	if(!mSystem->isGameListLoaded())
+		return false;
+
+	// only edits of this system count, a launch or a favorite toggle doesn't change any searched field
+	const unsigned int metaDataGeneration = mSystem->getMetaDataGeneration();
+	const unsigned int generation = mSystem->getGamesGeneration();
+
+	if(!mPassRunning)
+	{
+		if(mIndexed && (metaDataGeneration == mIndexedMetaDataGeneration) && (generation == mIndexedGeneration))
+			return true;
+
+		mPassRunning = true;
+		mPassCursor = 0;
+		mPassMetaDataGeneration = metaDataGeneration;
+		mPassGeneration = generation;
+		++mPass;
+	}
+	else if(generation != mPassGeneration)
+	{
+		// games were added or removed while the pass was running, the list it walked is gone
+		mPassCursor = 0;
+		mPassGeneration = generation;
+		++mPass;
+	}
+
+	const std::vector<FileData*>& games = mSystem->getGames();
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+
+	while(mPassCursor < games.size())
+	{
+		addGame(games[mPassCursor++]);
+
+		if((budgetMs >= 0) && ((mPassCursor % GAMES_PER_CLOCK_CHECK) == 0) && (std::chrono::steady_clock::now() >= deadline))
+			return false;
+	}
+
+	finishPass();
+	return mIndexed;
+}
+
+void GameSearchIndex::addGame(FileData* game)
+{
+	auto it = mDocumentIds.find(game);
+	if(it != mDocumentIds.cend())
+	{
+		if(it->second.revision == game->metadata.getRevision())
+		{
+			it->second.pass = mPass;
+			return;
+		}
+
+		// the postings aren't searched for the old words, the game is indexed under a new id instead
+		mDocuments[it->second.id] = nullptr;
+		++mDeadDocuments;
+	}
+
+	Document& document = mDocumentIds[game];
+	document.id = (unsigned int)mDocuments.size();
+	document.revision = game->metadata.getRevision();
+	document.pass = mPass;
+
+	mDocuments.push_back(game);
+	mStamps.push_back(0);
+
+	std::vector<std::string> words;
+	for(size_t i = 0; i < sizeof(sSearchedFields) / sizeof(sSearchedFields[0]); ++i)
+		getWords(game->metadata.get(sSearchedFields[i]), words);
+
+	std::sort(words.begin(), words.end());
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+
+	for(auto wordIt = words.cbegin(); wordIt != words.cend(); ++wordIt)
+		mWords[*wordIt].push_back(document.id);
+}
+
+void GameSearchIndex::finishPass()
+{
+	// the games this pass didn't come across have left the tree
+	for(auto it = mDocumentIds.begin(); it != mDocumentIds.end(); )
+	{
+		if(it->second.pass != mPass)
+		{
+			mDocuments[it->second.id] = nullptr;
+			++mDeadDocuments;
+			it = mDocumentIds.erase(it);
+		}
+		else
+			++it;
+	}
+
+	mPassRunning = false;
+
+	if((mDeadDocuments > MIN_DEAD_DOCUMENTS) && (mDeadDocuments > mDocumentIds.size()))
+	{
+		LOG(LogDebug) << "Search index of system \"" << mSystem->getName() << "\" holds " << mDeadDocuments << " outdated games, building it again";
+		clear();
+		return;
+	}
+
+	mIndexed = true;
+	mIndexedMetaDataGeneration = mPassMetaDataGeneration;
+	mIndexedGeneration = mPassGeneration;
+}
+
+void GameSearchIndex::clear()
+{
+	mWords.clear();
+	mDocuments.clear();
+	mStamps.clear();
+	mDocumentIds.clear();
+	mDeadDocuments = 0;
+	mStamp = 0;
+	mIndexed = false;
+}
+
+void GameSearchIndex::removeGame(FileData* game)
+{
+	auto it = mDocumentIds.find(game);
+	if(it == mDocumentIds.cend())
+		return;
+
+	mDocuments[it->second.id] = nullptr;
+	++mDeadDocuments;
+	mDocumentIds.erase(it);
+}
+
+bool GameSearchIndex::search(const std::string& query, std::vector<FileData*>& results)
+{
+	const bool upToDate = isUpToDate();
+
+	std::vector<std::string> words;
+	getWords(query, words);
+	if(words.empty())
+		return upToDate;
+
+	// every id carries the number of query words it matched so far, offset by mStamp so the stamps
+	// of the previous searches never have to be reset, a game matches once it reaches base + words
+	if(mStamp > 0xFFFFFFFFu - (unsigned int)words.size() - 2)
+	{
+		std::fill(mStamps.begin(), mStamps.end(), 0);
+		mStamp = 0;
+	}
+
+	const unsigned int base = mStamp + 1;
+	mStamp = base + (unsigned int)words.size() + 1;
+
+	for(size_t i = 0; i < words.size(); ++i)
+	{
+		const std::string& prefix = words[i];
+		const unsigned int stamp = base + (unsigned int)i;
+
+		for(auto it = mWords.lower_bound(prefix); (it != mWords.cend()) && (it->first.compare(0, prefix.size(), prefix) == 0); ++it)
+		{
+			for(auto idIt = it->second.cbegin(); idIt != it->second.cend(); ++idIt)
+			{
+				unsigned int& current = mStamps[*idIt];
+				if((i == 0) ? (current < base) : (current == stamp))
+					current = stamp + 1;
+			}
+		}
+	}
+
+	// the ids that matched every word are among the postings of the last one, collected ids move past the match
+	const std::string& prefix = words.back();
+	const unsigned int match = base + (unsigned int)words.size();
+
+	for(auto it = mWords.lower_bound(prefix); (it != mWords.cend()) && (it->first.compare(0, prefix.size(), prefix) == 0); ++it)
+	{
+		for(auto idIt = it->second.cbegin(); idIt != it->second.cend(); ++idIt)
+		{
+			if((mStamps[*idIt] == match) && mDocuments[*idIt])
+			{
+				mStamps[*idIt] = match + 1;
+				results.push_back(mDocuments[*idIt]);
+			}
+		}
+	}
+
+	return upToDate;
+}
+
+bool GameSearchIndex::updateAll(int budgetMs)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+	bool upToDate = true;
+
+	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
+	{
+		GameSearchIndex* index = (*it)->getSearchIndex();
+		if(!index)
+			continue;
+
+		// with LazySystemLoading the background loader gets to it eventually
+		if(!(*it)->isGameListLoaded())
+		{
+			upToDate = false;
+			continue;
+		}
+
+		if(index->isUpToDate())
+			continue;
+
+		const int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+		if((left <= 0) || !index->update(left))
+			return false;
+	}
+
+	return upToDate;
+}
+
+bool GameSearchIndex::searchAll(const std::string& query, std::vector<FileData*>& results)
+{
+	bool upToDate = true;
+
+	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
+	{
+		GameSearchIndex* index = (*it)->getSearchIndex();
+		if(index && !index->search(query, results))
+			upToDate = false;
+	}
+
+	return upToDate;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef ES_APP_GAME_SEARCH_INDEX_H
+#define ES_APP_GAME_SEARCH_INDEX_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileData;
+class SystemData;
+
+// Finds the games of a system by the words of their name, sort name, developer, publisher and description.
+// Every word of a query has to start a word of the game, "sup mar" finds "Super Mario World". The index is
+// built a few milliseconds per frame once the games are loaded and follows the games the same way, a pass
+// over them starts whenever games of the system were edited, added or removed and only indexes the changed
+// games again. Searches never wait for it, they're answered from the index as it stands.
+class GameSearchIndex
+{
+public:
+	GameSearchIndex(SystemData* system);
+
+	// indexes games for at most budgetMs (until done with -1), returns true once the index is up to date
+	bool update(int budgetMs);
+	bool isUpToDate() const;
+
+	// appends the games matching every word of query in no particular order, returns false if the index
+	// isn't up to date yet and games might be missing
+	bool search(const std::string& query, std::vector<FileData*>& results);
+
+	void removeGame(FileData* game); // the game is being deleted
+
+	static bool updateAll(int budgetMs); // the loaded game systems, from the main loop while SearchIndexInBackground is set
+	static bool searchAll(const std::string& query, std::vector<FileData*>& results); // every game system, systems that aren't loaded yet are skipped
+
+	// lower-cased words of text, split at anything that isn't a letter or a digit, non-ASCII characters are kept
+	static void getWords(const std::string& text, std::vector<std::string>& words);
+
+private:
+	struct Document
+	{
+		unsigned int id;
+		unsigned int revision; // of the metadata when it was indexed
+		unsigned int pass; // the last pass that found the game in the tree
+	};
+
+	void addGame(FileData* game);
+	void finishPass();
+	void clear();
+
+	SystemData* mSystem;
+
+	std::map<std::string, std::vector<unsigned int>> mWords; // sorted so the words starting with a prefix follow each other
+	std::vector<FileData*> mDocuments; // by id, nullptr once the game was indexed again or left the tree
+	std::vector<unsigned int> mStamps; // by id, how many words of the running search matched, see search()
+	std::unordered_map<FileData*, Document> mDocumentIds;
+	size_t mDeadDocuments;
+	unsigned int mStamp;
+
+	bool mPassRunning;
+	size_t mPassCursor; // in SystemData::getGames()
+	unsigned int mPass;
+	unsigned int mPassMetaDataGeneration; // see SystemData::getMetaDataGeneration
+	unsigned int mPassGeneration; // see SystemData::getGamesGeneration
+
+	bool mIndexed;
+	unsigned int mIndexedMetaDataGeneration;
+	unsigned int mIndexedGeneration;
+};
+
+#endif // ES_APP_GAME_SEARCH_INDEX_H
@@ -6,39 +6,54 @@
 #include "FileData.h"
 #include "FileFilterIndex.h"
 #include "Log.h"
+#include "MetaDataJournal.h"
 #include "Settings.h"
 #include "SystemData.h"
 #include <pugixml/src/pugixml.hpp>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
 
 FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType type)
 {
 	// first, verify that path is within the system's root folder
 	FileData* root = system->getRootFolder();
-	bool contains = false;
-	std::string relative = Utils::FileSystem::removeCommonPath2(path, root->getPath(), contains);
+	const std::string& rootPath = root->getPath();
 
-	if(!contains)
+	if(path.compare(0, rootPath.length(), rootPath) != 0)
 	{
 		LOG(LogError) << "File path \"" << path << "\" is outside system path \"" << system->getStartPath() << "\"";
 		return NULL;
 	}
 
-	Utils::FileSystem::stringList pathList = Utils::FileSystem::getPathList(relative);
-	auto path_it = pathList.begin();
+	// walk the path one folder at a time, reusing the same key for every lookup
 	FileData* treeNode = root;
+	std::string key;
 	bool found = false;
-	while(path_it != pathList.end())
+	size_t start = rootPath.length() + 1;
+	while(start < path.length())
 	{
-		const std::unordered_map<std::string, FileData*>& children = treeNode->getChildrenByFilename();
+		size_t end = path.find('/', start);
+		if(end == std::string::npos)
+			end = path.length();
 
-		std::string key = *path_it;
-		found = children.find(key) != children.cend();
+		if(end == start)
+		{
+			start = end + 1;
+			continue;
+		}
+
+		key.assign(path, start, end - start);
+
+		const FileData::ChildMap& children = treeNode->getChildrenByFilename();
+		const FileData::ChildMap::const_iterator child = children.find(key);
+		found = child != children.cend();
 		if (found) {
-			treeNode = children.at(key);
+			treeNode = child->second;
 		}
 
 		// this is the end
-		if(path_it == --pathList.end())
+		if(end == path.length())
 		{
 			if(found)
 				return treeNode;
@@ -49,7 +64,7 @@ FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType
 				return NULL;
 			}
 
-			FileData* file = new FileData(type, path, system->getSystemEnvData(), system);
+			FileData* file = new (system->getArena()) FileData(type, path, system->getSystemEnvData(), system);
 
 			// skipping arcade assets from gamelist
 			if(!file->isArcadeAsset())
@@ -70,12 +85,12 @@ FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType
 			}
 
 			// create missing folder
-			FileData* folder = new FileData(FOLDER, Utils::FileSystem::getStem(treeNode->getPath()) + "/" + *path_it, system->getSystemEnvData(), system);
+			FileData* folder = new (system->getArena()) FileData(FOLDER, Utils::FileSystem::getStem(treeNode->getPath()) + "/" + key, system->getSystemEnvData(), system);
 			treeNode->addChild(folder);
 			treeNode = folder;
 		}
 
-		path_it++;
+		start = end + 1;
 	}
 
 	return NULL;
@@ -91,8 +106,33 @@ void parseGamelist(SystemData* system)
 
 	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
 
+	const auto startTs = std::chrono::system_clock::now();
+
+	// read the file with a single read and let pugixml parse it in place, values then point straight into this buffer
+	std::vector<char> buffer;
+	FILE* xmlFile = fopen(xmlpath.c_str(), "rb");
+	if(xmlFile)
+	{
+		fseek(xmlFile, 0, SEEK_END);
+		long size = ftell(xmlFile);
+		fseek(xmlFile, 0, SEEK_SET);
+		if(size > 0)
+		{
+			buffer.resize((size_t)size);
+			if(fread(buffer.data(), 1, (size_t)size, xmlFile) != (size_t)size)
+				buffer.clear();
+		}
+		fclose(xmlFile);
+	}
+
+	if(buffer.empty())
+	{
+		LOG(LogError) << "Error reading XML file \"" << xmlpath << "\"!";
+		return;
+	}
+
 	pugi::xml_document doc;
-	pugi::xml_parse_result result = doc.load_file(xmlpath.c_str());
+	pugi::xml_parse_result result = doc.load_buffer_inplace(buffer.data(), buffer.size());
 
 	if(!result)
 	{
@@ -107,7 +147,9 @@ void parseGamelist(SystemData* system)
 		return;
 	}
 
-	std::string relativeTo = system->getStartPath();
+	const std::string& relativeTo = system->getStartPath();
+	std::string path;
+	int numEntries = 0;
 
 	const char* tagList[2] = { "game", "folder" };
 	FileType typeList[2] = { GAME, FOLDER };
@@ -117,9 +159,9 @@ void parseGamelist(SystemData* system)
 		FileType type = typeList[i];
 		for(pugi::xml_node fileNode = root.child(tag); fileNode; fileNode = fileNode.next_sibling(tag))
 		{
-			// Thanks to uza.vi for use of resolveRelativePath2 to speed things up over a Windows fileshare
+			// resolved into the same string for every entry, see resolveRelativePath2 for the original
 			// Source: https://retropie.org.uk/forum/topic/25571/improve-gamelist-parsing-for-large-rom-collection-in-emulationstation-for-windows
-			const std::string path = Utils::FileSystem::resolveRelativePath2(fileNode.child("path").text().get(), relativeTo, false);
+			Utils::FileSystem::resolveRelativePath(fileNode.child("path").text().get(), relativeTo, false, path);
 
 			if(!trustGamelist && !Utils::FileSystem::exists(path))
 			{
@@ -135,30 +177,28 @@ void parseGamelist(SystemData* system)
 			}
 			else if(!file->isArcadeAsset())
 			{
-				std::string defaultName = file->metadata.get("name");
-				file->metadata = MetaDataList::createFromXML(GAME_METADATA, fileNode, relativeTo);
-
-				//make sure name gets set if one didn't exist
-				if(file->metadata.get("name").empty())
-					file->metadata.set("name", defaultName);
-
+				file->metadata.assignFromXML(GAME_METADATA, fileNode, relativeTo);
 				file->metadata.resetChangedFlag();
+				++numEntries;
 			}
 		}
 	}
+
+	const auto endTs = std::chrono::system_clock::now();
+	LOG(LogInfo) << "Parsed " << numEntries << " entries from \"" << xmlpath << "\" in " << std::chrono::duration_cast<std::chrono::milliseconds>(endTs - startTs).count() << " ms";
 }
 
-void addFileDataNode(pugi::xml_node& parent, const FileData* file, const char* tag, SystemData* system)
+void addFileDataNode(pugi::xml_node& parent, const GamelistChanges::File& file, const char* tag, const std::string& startPath)
 {
 	//create game and add to parent node
 	pugi::xml_node newNode = parent.append_child(tag);
 
 	//write metadata
-	file->metadata.appendToXML(newNode, true, system->getStartPath());
+	file.metadata.appendToXML(newNode, true, startPath);
 
 	if(newNode.children().begin() == newNode.child("name") //first element is name
 		&& ++newNode.children().begin() == newNode.children().end() //theres only one element
-		&& newNode.child("name").text().get() == file->getDisplayName()) //the name is the default
+		&& newNode.child("name").text().get() == file.displayName) //the name is the default
 	{
 		//if the only info is the default name, don't bother with this node
 		//delete it and ultimately do nothing
@@ -167,109 +207,213 @@ void addFileDataNode(pugi::xml_node& parent, const FileData* file, const char* t
 		//there's something useful in there so we'll keep the node, add the path
 
 		// try and make the path relative if we can so things still work if we change the rom folder location in the future
-		newNode.prepend_child("path").text().set(Utils::FileSystem::createRelativePath(file->getPath(), system->getStartPath(), false).c_str());
+		newNode.prepend_child("path").text().set(Utils::FileSystem::createRelativePath(file.path, startPath, false).c_str());
+	}
+}
+
+// Finds the <game> or <folder> node of a path in a parsed gamelist. The nodes are only indexed once something
+// is looked up, by their resolved path first, the canonical paths (a stat per path component) are only worked
+// out if a path isn't found as is, which happens when the gamelist or the rom folder goes through a symlink.
+class GamelistIndex
+{
+public:
+	GamelistIndex(pugi::xml_node root, const char* tag, const std::string& relativeTo) : mRoot(root), mTag(tag), mRelativeTo(relativeTo), mIndexed(false), mCanonicalIndexed(false) { }
+
+	// the node is forgotten by the index, the caller removes it from the document
+	pugi::xml_node take(const std::string& path)
+	{
+		if(!mIndexed)
+			index();
+
+		std::unordered_map<std::string, size_t>::const_iterator it = mByPath.find(path);
+		if((it != mByPath.cend()) && mNodes[it->second])
+			return take(it->second);
+
+		if(!mCanonicalIndexed)
+		{
+			for(size_t i = 0; i < mPaths.size(); ++i)
+				mByCanonicalPath.emplace(Utils::FileSystem::getCanonicalPath(mPaths[i]), i);
+			mCanonicalIndexed = true;
+		}
+
+		it = mByCanonicalPath.find(Utils::FileSystem::getCanonicalPath(path));
+		if((it != mByCanonicalPath.cend()) && mNodes[it->second])
+			return take(it->second);
+
+		return pugi::xml_node();
+	}
+
+private:
+	pugi::xml_node take(size_t i)
+	{
+		pugi::xml_node node = mNodes[i];
+		mNodes[i] = pugi::xml_node();
+		return node;
+	}
+
+	void index()
+	{
+		std::string path;
+		for(pugi::xml_node fileNode = mRoot.child(mTag); fileNode; fileNode = fileNode.next_sibling(mTag))
+		{
+			pugi::xml_node pathNode = fileNode.child("path");
+			if(!pathNode)
+			{
+				LOG(LogError) << "<" << mTag << "> node contains no <path> child!";
+				continue;
+			}
+
+			Utils::FileSystem::resolveRelativePath(pathNode.text().get(), mRelativeTo, true, path);
+
+			// the first node of a path wins, like it did when the nodes were searched one by one
+			mByPath.emplace(path, mNodes.size());
+			mNodes.push_back(fileNode);
+			mPaths.push_back(path);
+		}
+		mIndexed = true;
+	}
+
+	pugi::xml_node mRoot;
+	const char* mTag;
+	const std::string& mRelativeTo;
+	bool mIndexed;
+	bool mCanonicalIndexed;
+
+	std::vector<pugi::xml_node> mNodes; // emptied once removed from the document
+	std::vector<std::string> mPaths;
+	std::unordered_map<std::string, size_t> mByPath;
+	std::unordered_map<std::string, size_t> mByCanonicalPath;
+};
+
+bool collectGamelistChanges(SystemData* system, GamelistChanges& changes)
+{
+	if(Settings::getInstance()->getBool("IgnoreGamelist"))
+		return false;
+
+	FileData* rootFolder = system->getRootFolder();
+	if(rootFolder == nullptr)
+	{
+		LOG(LogError) << "Found no root folder for system \"" << system->getName() << "\"!";
+		return false;
 	}
+
+	// metadata lists share their interned values, copying the changed ones is cheap
+	changes.files.clear();
+	rootFolder->visitFilesRecursive(GAME | FOLDER, false, [&](FileData* file) -> bool
+	{
+		// do not touch if it wasn't changed anyway
+		if(file->metadata.wasChanged())
+		{
+			GamelistChanges::File changed = { file->getType(), file->getPath(), file->getDisplayName(), file->metadata };
+			changes.files.push_back(changed);
+		}
+		return true;
+	});
+
+	if(changes.files.empty())
+		return false;
+
+	changes.systemName = system->getName();
+	changes.startPath = system->getStartPath();
+	changes.readPath = system->getGamelistPath(false);
+	changes.writePath = system->getGamelistPath(true);
+	changes.journalPath = system->getJournalPath();
+	changes.journalSize = getMetaDataJournalSize(system);
+	return true;
 }
 
-void updateGamelist(SystemData* system)
+bool writeGamelistChanges(const GamelistChanges& changes)
 {
 	//We do this by reading the XML again, adding changes and then writing it back,
 	//because there might be information missing in our systemdata which would then miss in the new XML.
 	//We have the complete information for every game though, so we can simply remove a game
 	//we already have in the system from the XML, and then add it back from its GameData information...
 
-	if(Settings::getInstance()->getBool("IgnoreGamelist"))
-		return;
+	const auto startTs = std::chrono::system_clock::now();
 
 	pugi::xml_document doc;
 	pugi::xml_node root;
-	std::string xmlReadPath = system->getGamelistPath(false);
 
-	if(Utils::FileSystem::exists(xmlReadPath))
+	if(Utils::FileSystem::exists(changes.readPath))
 	{
 		//parse an existing file first
-		pugi::xml_parse_result result = doc.load_file(xmlReadPath.c_str());
+		pugi::xml_parse_result result = doc.load_file(changes.readPath.c_str());
 
 		if(!result)
 		{
-			LOG(LogError) << "Error parsing XML file \"" << xmlReadPath << "\"!\n	" << result.description();
-			return;
+			LOG(LogError) << "Error parsing XML file \"" << changes.readPath << "\"!\n	" << result.description();
+			return false;
 		}
 
 		root = doc.child("gameList");
 		if(!root)
 		{
-			LOG(LogError) << "Could not find <gameList> node in gamelist \"" << xmlReadPath << "\"!";
-			return;
+			LOG(LogError) << "Could not find <gameList> node in gamelist \"" << changes.readPath << "\"!";
+			return false;
 		}
 	}else{
 		//set up an empty gamelist to append to
 		root = doc.append_child("gameList");
 	}
 
+	//now we have all the information from the XML. now iterate through all our changes and add information from there
+	GamelistIndex games(root, "game", changes.startPath);
+	GamelistIndex folders(root, "folder", changes.startPath);
 
-	//now we have all the information from the XML. now iterate through all our games and add information from there
-	FileData* rootFolder = system->getRootFolder();
-	if (rootFolder != nullptr)
+	for(auto it = changes.files.cbegin(); it != changes.files.cend(); ++it)
 	{
-		int numUpdated = 0;
+		const char* tag = (it->type == GAME) ? "game" : "folder";
 
-		//get only files, no folders
-		std::vector<FileData*> files = rootFolder->getFilesRecursive(GAME | FOLDER);
-		//iterate through all files, checking if they're already in the XML
-		for(std::vector<FileData*>::const_iterator fit = files.cbegin(); fit != files.cend(); ++fit)
-		{
-			const char* tag = ((*fit)->getType() == GAME) ? "game" : "folder";
+		// check if the file already exists in the XML
+		// if it does, remove it before adding
+		GamelistIndex& index = (it->type == GAME) ? games : folders;
+		pugi::xml_node fileNode = index.take(it->path);
+		if(fileNode)
+			root.remove_child(fileNode);
 
-			// do not touch if it wasn't changed anyway
-			if (!(*fit)->metadata.wasChanged())
-				continue;
+		// it was either removed or never existed to begin with; either way, we can add it now
+		addFileDataNode(root, *it, tag, changes.startPath);
+	}
 
-			// check if the file already exists in the XML
-			// if it does, remove it before adding
-			for(pugi::xml_node fileNode = root.child(tag); fileNode; fileNode = fileNode.next_sibling(tag))
-			{
-				pugi::xml_node pathNode = fileNode.child("path");
-				if(!pathNode)
-				{
-					LOG(LogError) << "<" << tag << "> node contains no <path> child!";
-					continue;
-				}
-
-				std::string nodePath = Utils::FileSystem::getCanonicalPath(Utils::FileSystem::resolveRelativePath(pathNode.text().get(), system->getStartPath(), true));
-				std::string gamePath = Utils::FileSystem::getCanonicalPath((*fit)->getPath());
-				if(nodePath == gamePath)
-				{
-					// found it
-					root.remove_child(fileNode);
-					break;
-				}
-			}
+	//now write the file
 
-			// it was either removed or never existed to begin with; either way, we can add it now
-			addFileDataNode(root, *fit, tag, system);
-			++numUpdated;
-		}
+	//make sure the folders leading up to this path exist (or the write will fail)
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(changes.writePath));
 
-		//now write the file
+	LOG(LogInfo) << "Added/Updated " << changes.files.size() << " entities in '" << changes.readPath << "'";
 
-		if (numUpdated > 0) {
-			const auto startTs = std::chrono::system_clock::now();
+	// write to a temporary file first so an interrupted write never leaves a truncated gamelist behind
+	const std::string tempPath = changes.writePath + ".tmp";
+	if (!doc.save_file(tempPath.c_str())) {
+		LOG(LogError) << "Error saving gamelist.xml to \"" << tempPath << "\" (for system " << changes.systemName << ")!";
+		Utils::FileSystem::removeFile(tempPath);
+		return false;
+	}
 
-			//make sure the folders leading up to this path exist (or the write will fail)
-			std::string xmlWritePath(system->getGamelistPath(true));
-			Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(xmlWritePath));
+	// rename replaces the old gamelist in one go, except on Windows where it has to be removed first
+	if(rename(tempPath.c_str(), changes.writePath.c_str()) != 0)
+	{
+		Utils::FileSystem::removeFile(changes.writePath);
+		if(rename(tempPath.c_str(), changes.writePath.c_str()) != 0)
+		{
+			LOG(LogError) << "Error - could not rename \"" << tempPath << "\" to \"" << changes.writePath << "\" (for system " << changes.systemName << ")!";
+			return false;
+		}
+	}
 
-			LOG(LogInfo) << "Added/Updated " << numUpdated << " entities in '" << xmlReadPath << "'";
+	// everything the journal held when the changes were copied is in the gamelist now
+	removeMetaDataJournal(changes.journalPath, changes.journalSize);
 
-			if (!doc.save_file(xmlWritePath.c_str())) {
-				LOG(LogError) << "Error saving gamelist.xml to \"" << xmlWritePath << "\" (for system " << system->getName() << ")!";
-			}
+	const auto endTs = std::chrono::system_clock::now();
+	LOG(LogInfo) << "Saved gamelist.xml for system \"" << changes.systemName << "\" in " << std::chrono::duration_cast<std::chrono::milliseconds>(endTs - startTs).count() << " ms";
+	return true;
+}
 
-			const auto endTs = std::chrono::system_clock::now();
-			LOG(LogInfo) << "Saved gamelist.xml for system \"" << system->getName() << "\" in " << std::chrono::duration_cast<std::chrono::milliseconds>(endTs - startTs).count() << " ms";
-		}
-	}else{
-		LOG(LogError) << "Found no root folder for system \"" << system->getName() << "\"!";
-	}
+bool updateGamelist(SystemData* system)
+{
+	GamelistChanges changes;
+	if(!collectGamelistChanges(system, changes))
+		return true;
+
+	return writeGamelistChanges(changes);
 }
@@ -2,12 +2,43 @@
 #ifndef ES_APP_GAME_LIST_H
 #define ES_APP_GAME_LIST_H
 
+#include "FileData.h"
+#include <string>
+#include <vector>
+
 class SystemData;
 
+// The changed metadata of a SystemData copied out of its tree, so the gamelist can be written on another thread
+// while the tree keeps changing.
+struct GamelistChanges
+{
+	struct File
+	{
+		FileType type;
+		std::string path;
+		std::string displayName;
+		MetaDataList metadata;
+	};
+
+	std::string systemName;
+	std::string startPath;
+	std::string readPath;
+	std::string writePath;
+	std::string journalPath; // see MetaDataJournal.h
+	long long journalSize; // when the changes were copied
+	std::vector<File> files;
+};
+
 // Loads gamelist.xml data into a SystemData.
 void parseGamelist(SystemData* system);
 
+// Copies the changed metadata of a SystemData, returns false if there is nothing to write.
+bool collectGamelistChanges(SystemData* system, GamelistChanges& changes);
+
+// Merges changes into gamelist.xml, only works with changes so it can run on any thread.
+bool writeGamelistChanges(const GamelistChanges& changes); // false if the gamelist couldn't be read or written
+
 // Writes currently loaded metadata for a SystemData to gamelist.xml.
-void updateGamelist(SystemData* system);
+bool updateGamelist(SystemData* system); // false if the gamelist couldn't be read or written
 
 #endif // ES_APP_GAME_LIST_H
@@ -0,0 +1,345 @@
+#include "GamelistSnapshot.h"
+
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "Log.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// bump whenever the layout below changes, older snapshots are then simply ignored
+#define SNAPSHOT_MAGIC   "ESGLSNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ENDIAN  0x01020304
+
+// Layout, all integers in native byte order (a snapshot is only ever read back by the machine that wrote it):
+//   magic, u32 version, u32 endian marker, string signature
+//   string gamelist path, i64 gamelist mtime
+//   u32 folder count, { string path, i64 mtime }...
+//   u32 root child count, node...
+// node:
+//   u8 type, u8 metadata type, u8 path is relative to the parent, string path
+//   u32 metadata count, { string key, string value }...   (only values that differ from the defaults)
+//   u32 child count, node...                              (folders only)
+// strings are a u32 length followed by the bytes, without terminator
+
+static std::string getSignature(SystemData* system)
+{
+	// everything the tree depends on besides the filesystem and the gamelist
+	std::string signature = system->getStartPath();
+	signature += Settings::getInstance()->getBool("ShowHiddenFiles")   ? "|hidden"    : "|nohidden";
+	signature += Settings::getInstance()->getBool("ParseGamelistOnly") ? "|parseonly" : "|scan";
+	signature += Settings::getInstance()->getBool("IgnoreGamelist")    ? "|ignore"    : "|gamelist";
+	signature += system->getSystemEnvData()->mExtensionMatcher.ignoresCase() ? "|nocase" : "|case";
+	for(auto it = system->getExtensions().cbegin(); it != system->getExtensions().cend(); ++it)
+		signature += " " + *it;
+
+	return signature;
+}
+
+class SnapshotWriter
+{
+public:
+	void writeU8 (uint8_t  value) { mBuffer.push_back((char)value); }
+	void writeU32(uint32_t value) { mBuffer.append((const char*)&value, sizeof(value)); }
+	void writeI64(int64_t  value) { mBuffer.append((const char*)&value, sizeof(value)); }
+	void writeString(const std::string& value) { writeU32((uint32_t)value.size()); mBuffer.append(value); }
+
+	void writeNode(const FileData* file, const std::string& parentPath)
+	{
+		writeU8((uint8_t)file->getType());
+		writeU8((uint8_t)file->metadata.getType());
+
+		// most paths only add their file name to the parent folder path
+		const std::string& path = file->getPath();
+		if((path.size() > parentPath.size() + 1) && (path.compare(0, parentPath.size(), parentPath) == 0) && (path[parentPath.size()] == '/'))
+		{
+			writeU8(1);
+			writeString(path.substr(parentPath.size() + 1));
+		}
+		else
+		{
+			writeU8(0);
+			writeString(path);
+		}
+
+		const std::vector<MetaDataDecl>& mdd = file->metadata.getMDD();
+		uint32_t count = 0;
+		for(auto it = mdd.cbegin(); it != mdd.cend(); ++it)
+		{
+			if(!file->metadata.isDefault(it->id))
+				++count;
+		}
+
+		writeU32(count);
+		for(auto it = mdd.cbegin(); it != mdd.cend(); ++it)
+		{
+			if(!file->metadata.isDefault(it->id))
+			{
+				writeString(it->key);
+				writeString(file->metadata.get(it->id));
+			}
+		}
+
+		if(file->getType() == FOLDER)
+			writeChildren(file);
+	}
+
+	void writeChildren(const FileData* folder)
+	{
+		const std::vector<FileData*>& children = folder->getChildren();
+		writeU32((uint32_t)children.size());
+		for(auto it = children.cbegin(); it != children.cend(); ++it)
+			writeNode(*it, folder->getPath());
+	}
+
+	const std::string& getBuffer() const { return mBuffer; }
+
+private:
+	std::string mBuffer;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(const char* data, size_t size) : mCursor(data), mEnd(data + size) { }
+
+	bool readU8 (uint8_t&  value) { return read(&value, sizeof(value)); }
+	bool readU32(uint32_t& value) { return read(&value, sizeof(value)); }
+	bool readI64(int64_t&  value) { return read(&value, sizeof(value)); }
+	bool readString(std::string& value)
+	{
+		uint32_t size;
+		if(!readU32(size) || (size > (size_t)(mEnd - mCursor)))
+			return false;
+
+		value.assign(mCursor, size);
+		mCursor += size;
+		return true;
+	}
+	bool skipString()
+	{
+		uint32_t size;
+		if(!readU32(size) || (size > (size_t)(mEnd - mCursor)))
+			return false;
+
+		mCursor += size;
+		return true;
+	}
+
+	// with parent == nullptr the nodes are only checked, so a damaged snapshot is refused before anything gets created
+	bool readChildren(FileData* parent, SystemData* system)
+	{
+		uint32_t count;
+		if(!readU32(count))
+			return false;
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			if(!readNode(parent, system))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool readNode(FileData* parent, SystemData* system)
+	{
+		uint8_t type;
+		uint8_t metadataType;
+		uint8_t relative;
+		if(!readU8(type) || !readU8(metadataType) || !readU8(relative))
+			return false;
+
+		if(((type != GAME) && (type != FOLDER)) || ((metadataType != GAME_METADATA) && (metadataType != FOLDER_METADATA)))
+			return false;
+
+		uint32_t count;
+		if(!parent)
+		{
+			if(!skipString() || !readU32(count))
+				return false;
+
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				if(!skipString() || !skipString())
+					return false;
+			}
+
+			return (type == GAME) || readChildren(nullptr, system);
+		}
+
+		std::string path;
+		readString(path);
+		if(relative)
+			path = parent->getPath() + "/" + path;
+
+		FileData* file = new (system->getArena()) FileData((FileType)type, path, system->getSystemEnvData(), system);
+		file->metadata = MetaDataList((MetaDataListType)metadataType);
+
+		std::string key;
+		std::string value;
+		readU32(count);
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			readString(key);
+			readString(value);
+			file->metadata.set(key, value);
+		}
+		file->metadata.resetChangedFlag();
+
+		parent->addChild(file);
+
+		return (type == GAME) || readChildren(file, system);
+	}
+
+	bool atEnd() const { return mCursor == mEnd; }
+
+private:
+	bool read(void* value, size_t size)
+	{
+		if(size > (size_t)(mEnd - mCursor))
+			return false;
+
+		memcpy(value, mCursor, size);
+		mCursor += size;
+		return true;
+	}
+
+	const char* mCursor;
+	const char* mEnd;
+};
+
+bool loadGamelistSnapshot(SystemData* system)
+{
+	const std::string path = system->getSnapshotPath();
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if(!file)
+		return false;
+
+	// the whole snapshot is read with a single read and decoded in place
+	std::string data;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if(size > 0)
+	{
+		data.resize((size_t)size);
+		if(fread(&data[0], 1, (size_t)size, file) != (size_t)size)
+			data.clear();
+	}
+	fclose(file);
+
+	const size_t magicSize = strlen(SNAPSHOT_MAGIC);
+	if((data.size() < magicSize) || (data.compare(0, magicSize, SNAPSHOT_MAGIC) != 0))
+		return false;
+
+	SnapshotReader reader(data.data() + magicSize, data.size() - magicSize);
+
+	uint32_t version;
+	uint32_t endian;
+	std::string signature;
+	if(!reader.readU32(version) || (version != SNAPSHOT_VERSION) || !reader.readU32(endian) || (endian != SNAPSHOT_ENDIAN))
+	{
+		LOG(LogInfo) << "Ignoring gamelist snapshot \"" << path << "\" written by another version";
+		return false;
+	}
+
+	if(!reader.readString(signature) || (signature != getSignature(system)))
+	{
+		LOG(LogInfo) << "Ignoring gamelist snapshot \"" << path << "\", the system configuration changed";
+		return false;
+	}
+
+	std::string gamelistPath;
+	int64_t gamelistModified;
+	if(!reader.readString(gamelistPath) || !reader.readI64(gamelistModified))
+		return false;
+
+	if((gamelistPath != system->getGamelistPath(false)) || (gamelistModified != Utils::FileSystem::getModifiedTime(gamelistPath)))
+	{
+		LOG(LogInfo) << "Gamelist of system \"" << system->getName() << "\" changed, ignoring its snapshot";
+		return false;
+	}
+
+	// one stat per folder instead of listing them and parsing the gamelist again
+	uint32_t folderCount;
+	if(!reader.readU32(folderCount))
+		return false;
+
+	std::string folderPath;
+	int64_t folderModified;
+	for(uint32_t i = 0; i < folderCount; ++i)
+	{
+		if(!reader.readString(folderPath) || !reader.readI64(folderModified))
+			return false;
+
+		if(folderModified != Utils::FileSystem::getModifiedTime(folderPath))
+		{
+			LOG(LogInfo) << "Folder \"" << folderPath << "\" changed, ignoring the snapshot of system \"" << system->getName() << "\"";
+			return false;
+		}
+	}
+
+	SnapshotReader tree = reader;
+	if(!reader.readChildren(nullptr, system) || !reader.atEnd())
+	{
+		LOG(LogWarning) << "Gamelist snapshot \"" << path << "\" is damaged, ignoring it";
+		return false;
+	}
+
+	tree.readChildren(system->getRootFolder(), system);
+
+	LOG(LogInfo) << "Loaded system \"" << system->getName() << "\" from its gamelist snapshot";
+	return true;
+}
+
+void saveGamelistSnapshot(SystemData* system, const std::vector<SnapshotFolder>& folders, const std::string& gamelistPath, long long gamelistModified)
+{
+	SnapshotWriter writer;
+	writer.writeU32(SNAPSHOT_VERSION);
+	writer.writeU32(SNAPSHOT_ENDIAN);
+	writer.writeString(getSignature(system));
+	writer.writeString(gamelistPath);
+	writer.writeI64(gamelistModified);
+
+	writer.writeU32((uint32_t)folders.size());
+	for(auto it = folders.cbegin(); it != folders.cend(); ++it)
+	{
+		writer.writeString(it->path);
+		writer.writeI64(it->modified);
+	}
+
+	writer.writeChildren(system->getRootFolder());
+
+	const std::string path = system->getSnapshotPath();
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(path));
+
+	// write to a temporary file first so an interrupted write never leaves a truncated snapshot behind
+	const std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if(!file)
+	{
+		LOG(LogError) << "Error - could not write gamelist snapshot \"" << tempPath << "\"";
+		return;
+	}
+
+	const std::string& buffer = writer.getBuffer();
+	bool written = (fwrite(SNAPSHOT_MAGIC, 1, strlen(SNAPSHOT_MAGIC), file) == strlen(SNAPSHOT_MAGIC));
+	written = written && (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+	written = (fclose(file) == 0) && written;
+
+	if(!written)
+	{
+		LOG(LogError) << "Error - could not write gamelist snapshot \"" << tempPath << "\"";
+		Utils::FileSystem::removeFile(tempPath);
+		return;
+	}
+
+	Utils::FileSystem::removeFile(path);
+	if(rename(tempPath.c_str(), path.c_str()) != 0)
+		LOG(LogError) << "Error - could not rename gamelist snapshot \"" << tempPath << "\" to \"" << path << "\"";
+}
@@ -0,0 +1,25 @@
+#pragma once
+#ifndef ES_APP_GAMELIST_SNAPSHOT_H
+#define ES_APP_GAMELIST_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+class SystemData;
+
+// A rom folder as it was when the tree was built, the snapshot is outdated as soon as one of them changes.
+struct SnapshotFolder
+{
+	std::string path;
+	long long modified;
+};
+
+// Restores the game tree and metadata of a SystemData from its binary snapshot.
+// Returns false, leaving the system untouched, if there is no snapshot or if the gamelist or a rom folder changed since it was written.
+bool loadGamelistSnapshot(SystemData* system);
+
+// Writes the current game tree and metadata of a SystemData to its binary snapshot.
+// folders and gamelistModified must be read before the folders were listed and the gamelist was parsed.
+void saveGamelistSnapshot(SystemData* system, const std::vector<SnapshotFolder>& folders, const std::string& gamelistPath, long long gamelistModified);
+
+#endif // ES_APP_GAMELIST_SNAPSHOT_H
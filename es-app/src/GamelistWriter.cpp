@@ -0,0 +1,175 @@
+#include "GamelistWriter.h"
+
+#include "Gamelist.h"
+#include "Log.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <chrono>
+
+GamelistWriter* GamelistWriter::sInstance = nullptr;
+
+void GamelistWriter::init()
+{
+	if(!sInstance)
+		sInstance = new GamelistWriter();
+
+} // init
+
+void GamelistWriter::deinit()
+{
+	if(sInstance)
+	{
+		// threads that are still writing after the last flush keep using the instance, it's left to the process exit
+		if(sInstance->flush(0))
+			delete sInstance;
+		sInstance = nullptr;
+	}
+
+} // deinit
+
+GamelistWriter* GamelistWriter::getInstance()
+{
+	if(!sInstance)
+		sInstance = new GamelistWriter();
+
+	return sInstance;
+
+} // getInstance
+
+GamelistWriter::GamelistWriter() : mThread(nullptr), mStopping(false)
+{
+} // GamelistWriter
+
+GamelistWriter::~GamelistWriter()
+{
+	if(mThread)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStopping = true;
+			mWakeUp.notify_all();
+		}
+
+		mThread->join();
+		delete mThread;
+	}
+
+} // ~GamelistWriter
+
+void GamelistWriter::save(SystemData* system)
+{
+	std::shared_ptr<GamelistChanges> changes = std::make_shared<GamelistChanges>();
+	if(!collectGamelistChanges(system, *changes))
+		return;
+
+	if(!Settings::getInstance()->getBool("SaveGamelistsInBackground"))
+	{
+		writeGamelistChanges(*changes);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	// the changes of a system accumulate until it's written, the newer copy holds everything the older one did
+	bool queued = false;
+	for(auto it = mQueue.begin(); it != mQueue.end(); ++it)
+	{
+		if((*it)->systemName == changes->systemName)
+		{
+			*it = changes;
+			queued = true;
+			break;
+		}
+	}
+
+	if(!queued)
+		mQueue.push_back(changes);
+
+	if(!mThread)
+		mThread = new std::thread(&GamelistWriter::work, this, true);
+
+	mWakeUp.notify_all();
+
+} // save
+
+bool GamelistWriter::flush(int timeoutMs)
+{
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	std::vector<std::thread> threads;
+	bool done;
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		// the background thread takes its share as well
+		for(size_t i = 0; i < mQueue.size(); ++i)
+			threads.push_back(std::thread(&GamelistWriter::work, this, false));
+
+		while(!mQueue.empty() || !mWriting.empty())
+		{
+			if(mDone.wait_until(lock, deadline) == std::cv_status::timeout)
+				break;
+		}
+
+		done = mQueue.empty() && mWriting.empty();
+	}
+
+	for(auto it = threads.begin(); it != threads.end(); ++it)
+	{
+		if(done)
+			it->join();
+		else
+			it->detach();
+	}
+
+	if(!done)
+		LOG(LogWarning) << "Gave up waiting for the gamelists still being saved after " << timeoutMs << " ms";
+
+	return done;
+
+} // flush
+
+std::shared_ptr<GamelistChanges> GamelistWriter::takeJob()
+{
+	for(auto it = mQueue.begin(); it != mQueue.end(); ++it)
+	{
+		if(mWriting.find((*it)->systemName) == mWriting.cend())
+		{
+			std::shared_ptr<GamelistChanges> job = *it;
+			mQueue.erase(it);
+			mWriting.insert(job->systemName);
+			return job;
+		}
+	}
+
+	return nullptr;
+
+} // takeJob
+
+void GamelistWriter::work(bool background)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while(true)
+	{
+		std::shared_ptr<GamelistChanges> job = takeJob();
+		if(!job)
+		{
+			if(!background || mStopping)
+				return;
+
+			mWakeUp.wait(lock);
+			continue;
+		}
+
+		lock.unlock();
+		writeGamelistChanges(*job);
+		lock.lock();
+
+		// a newer copy of the same system may have been waiting for this one
+		mWriting.erase(job->systemName);
+		mDone.notify_all();
+		mWakeUp.notify_all();
+	}
+
+} // work
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef ES_APP_GAMELIST_WRITER_H
+#define ES_APP_GAMELIST_WRITER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SystemData;
+struct GamelistChanges;
+
+// Writes the gamelists on a background thread so the UI doesn't stall while the XML is merged and saved.
+// The changed metadata is copied on the calling thread, a system saved again before its previous copy was
+// written only keeps the newer one. Gamelists are replaced through a temporary file, see writeGamelistChanges.
+class GamelistWriter
+{
+public:
+
+	static void            init       ();
+	static void            deinit     (); // writes what's still queued first, see flush()
+	static GamelistWriter* getInstance();
+
+	// writes right away, on the calling thread, when SaveGamelistsInBackground is off
+	void save(SystemData* system);
+
+	// writes everything queued with one thread per system, returns false if that took more than timeoutMs,
+	// the writes still running are then left to finish on their own
+	bool flush(int timeoutMs);
+
+private:
+
+	 GamelistWriter();
+	~GamelistWriter();
+
+	static GamelistWriter* sInstance;
+
+	std::shared_ptr<GamelistChanges> takeJob(); // the first queued system that isn't being written, mMutex must be held
+	void work(bool background); // the background thread waits for more, the threads of flush() stop once the queue is empty
+
+	std::mutex                                    mMutex;
+	std::condition_variable                       mWakeUp; // something was queued or a system was written
+	std::condition_variable                       mDone;   // a system was written
+	std::vector<std::shared_ptr<GamelistChanges>> mQueue;
+	std::set<std::string>                         mWriting; // names of the systems being written, never twice at once
+	std::thread*                                  mThread;
+	bool                                          mStopping;
+
+}; // GamelistWriter
+
+#endif // ES_APP_GAMELIST_WRITER_H
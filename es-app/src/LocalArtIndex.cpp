@@ -0,0 +1,55 @@
+#include "LocalArtIndex.h"
+
+#include "utils/FileSystemUtil.h"
+#include "Log.h"
+
+#define MODIFIED_CHECK_INTERVAL std::chrono::seconds(1)
+
+LocalArtIndex::LocalArtIndex() : mModified(0), mListed(false)
+{
+}
+
+void LocalArtIndex::setDirectory(const std::string& path)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	mPath = path;
+	mListed = false;
+	mFiles.clear();
+}
+
+std::string LocalArtIndex::find(const std::string& fileName)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	refresh();
+
+	if(mFiles.find(fileName) == mFiles.cend())
+		return "";
+
+	return mPath + "/" + fileName;
+}
+
+void LocalArtIndex::refresh()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if(mListed && (now - mLastCheck < MODIFIED_CHECK_INTERVAL))
+		return;
+
+	mLastCheck = now;
+
+	// adding, removing or renaming a file changes the modification time of the directory
+	const long long modified = Utils::FileSystem::getModifiedTime(mPath);
+	if(mListed && (modified == mModified))
+		return;
+
+	mModified = modified;
+	mListed = true;
+	mFiles.clear();
+
+	const Utils::FileSystem::stringList content = Utils::FileSystem::getDirContent(mPath);
+	for(auto it = content.cbegin(); it != content.cend(); ++it)
+		mFiles.insert(Utils::FileSystem::getFileName(*it));
+
+	LOG(LogDebug) << "Indexed " << mFiles.size() << " local art files in \"" << mPath << "\"";
+}
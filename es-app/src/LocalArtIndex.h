@@ -0,0 +1,34 @@
+#pragma once
+#ifndef ES_APP_LOCAL_ART_INDEX_H
+#define ES_APP_LOCAL_ART_INDEX_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+// The files of a system's <rom folder>/images directory, for the LocalArt lookups of FileData.
+// The directory is listed once when first needed and listed again only when its modification time changed,
+// which is checked at most once per second, so a lookup is a hash lookup without any filesystem call.
+class LocalArtIndex
+{
+public:
+	LocalArtIndex();
+
+	void setDirectory(const std::string& path);
+
+	// the full path of fileName in the directory, or an empty string if there's no such file
+	std::string find(const std::string& fileName);
+
+private:
+	void refresh();
+
+	std::string mPath;
+	long long mModified;
+	bool mListed;
+	std::chrono::steady_clock::time_point mLastCheck;
+	std::unordered_set<std::string> mFiles;
+	std::mutex mMutex;
+};
+
+#endif // ES_APP_LOCAL_ART_INDEX_H
@@ -1,46 +1,50 @@
 #include "MetaData.h"
 
 #include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
 #include "Log.h"
+#include "StringPool.h"
 #include <pugixml/src/pugixml.hpp>
+#include <atomic>
+#include <unordered_map>
 
 MetaDataDecl gameDecls[] = {
-	// key,         type,                   default,            statistic,  name in GuiMetaDataEd,  prompt in GuiMetaDataEd
-	{"name",        MD_STRING,              "",                 false,      "name",                 "enter game name"},
-	{"sortname",    MD_STRING,              "",                 false,      "sortname",             "enter game sort name"},
-	{"desc",        MD_MULTILINE_STRING,    "",                 false,      "description",          "enter description"},
-	{"image",       MD_PATH,                "",                 false,      "image",                "enter path to image"},
-	{"video",       MD_PATH     ,           "",                 false,      "video",                "enter path to video"},
-	{"marquee",     MD_PATH,                "",                 false,      "marquee",              "enter path to marquee"},
-	{"thumbnail",   MD_PATH,                "",                 false,      "thumbnail",            "enter path to thumbnail"},
-	{"rating",      MD_RATING,              "0.000000",         false,      "rating",               "enter rating"},
-	{"releasedate", MD_DATE,                "not-a-date-time",  false,      "release date",         "enter release date"},
-	{"developer",   MD_STRING,              "unknown",          false,      "developer",            "enter game developer"},
-	{"publisher",   MD_STRING,              "unknown",          false,      "publisher",            "enter game publisher"},
-	{"genre",       MD_STRING,              "unknown",          false,      "genre",                "enter game genre"},
-	{"players",     MD_INT,                 "1",                false,      "players",              "enter number of players"},
-	{"favorite",    MD_BOOL,                "false",            false,      "favorite",             "enter favorite off/on"},
-	{"hidden",      MD_BOOL,                "false",            false,      "hidden",               "enter hidden off/on" },
-	{"kidgame",     MD_BOOL,                "false",            false,      "kidgame",              "enter kidgame off/on" },
-	{"playcount",   MD_INT,                 "0",                true,       "play count",           "enter number of times played"},
-	{"lastplayed",  MD_TIME,                "0",                true,       "last played",          "enter last played date"}
+	// id,              key,         type,                   default,            statistic,  name in GuiMetaDataEd,  prompt in GuiMetaDataEd
+	{META_NAME,        "name",        MD_STRING,              "",                 false,      "name",                 "enter game name"},
+	{META_SORTNAME,    "sortname",    MD_STRING,              "",                 false,      "sortname",             "enter game sort name"},
+	{META_DESC,        "desc",        MD_MULTILINE_STRING,    "",                 false,      "description",          "enter description"},
+	{META_IMAGE,       "image",       MD_PATH,                "",                 false,      "image",                "enter path to image"},
+	{META_VIDEO,       "video",       MD_PATH     ,           "",                 false,      "video",                "enter path to video"},
+	{META_MARQUEE,     "marquee",     MD_PATH,                "",                 false,      "marquee",              "enter path to marquee"},
+	{META_THUMBNAIL,   "thumbnail",   MD_PATH,                "",                 false,      "thumbnail",            "enter path to thumbnail"},
+	{META_RATING,      "rating",      MD_RATING,              "0.000000",         false,      "rating",               "enter rating"},
+	{META_RELEASEDATE, "releasedate", MD_DATE,                "not-a-date-time",  false,      "release date",         "enter release date"},
+	{META_DEVELOPER,   "developer",   MD_STRING,              "unknown",          false,      "developer",            "enter game developer"},
+	{META_PUBLISHER,   "publisher",   MD_STRING,              "unknown",          false,      "publisher",            "enter game publisher"},
+	{META_GENRE,       "genre",       MD_STRING,              "unknown",          false,      "genre",                "enter game genre"},
+	{META_PLAYERS,     "players",     MD_INT,                 "1",                false,      "players",              "enter number of players"},
+	{META_FAVORITE,    "favorite",    MD_BOOL,                "false",            false,      "favorite",             "enter favorite off/on"},
+	{META_HIDDEN,      "hidden",      MD_BOOL,                "false",            false,      "hidden",               "enter hidden off/on" },
+	{META_KIDGAME,     "kidgame",     MD_BOOL,                "false",            false,      "kidgame",              "enter kidgame off/on" },
+	{META_PLAYCOUNT,   "playcount",   MD_INT,                 "0",                true,       "play count",           "enter number of times played"},
+	{META_LASTPLAYED,  "lastplayed",  MD_TIME,                "0",                true,       "last played",          "enter last played date"}
 };
 const std::vector<MetaDataDecl> gameMDD(gameDecls, gameDecls + sizeof(gameDecls) / sizeof(gameDecls[0]));
 
 MetaDataDecl folderDecls[] = {
-	{"name",        MD_STRING,              "",                 false,      "name",                 "enter game name"},
-	{"sortname",    MD_STRING,              "",                 false,      "sortname",             "enter game sort name"},
-	{"desc",        MD_MULTILINE_STRING,    "",                 false,      "description",          "enter description"},
-	{"image",       MD_PATH,                "",                 false,      "image",                "enter path to image"},
-	{"thumbnail",   MD_PATH,                "",                 false,      "thumbnail",            "enter path to thumbnail"},
-	{"video",       MD_PATH,                "",                 false,      "video",                "enter path to video"},
-	{"marquee",     MD_PATH,                "",                 false,      "marquee",              "enter path to marquee"},
-	{"rating",      MD_RATING,              "0.000000",         false,      "rating",               "enter rating"},
-	{"releasedate", MD_DATE,                "not-a-date-time",  false,      "release date",         "enter release date"},
-	{"developer",   MD_STRING,              "unknown",          false,      "developer",            "enter game developer"},
-	{"publisher",   MD_STRING,              "unknown",          false,      "publisher",            "enter game publisher"},
-	{"genre",       MD_STRING,              "unknown",          false,      "genre",                "enter game genre"},
-	{"players",     MD_INT,                 "1",                false,      "players",              "enter number of players"}
+	{META_NAME,        "name",        MD_STRING,              "",                 false,      "name",                 "enter game name"},
+	{META_SORTNAME,    "sortname",    MD_STRING,              "",                 false,      "sortname",             "enter game sort name"},
+	{META_DESC,        "desc",        MD_MULTILINE_STRING,    "",                 false,      "description",          "enter description"},
+	{META_IMAGE,       "image",       MD_PATH,                "",                 false,      "image",                "enter path to image"},
+	{META_THUMBNAIL,   "thumbnail",   MD_PATH,                "",                 false,      "thumbnail",            "enter path to thumbnail"},
+	{META_VIDEO,       "video",       MD_PATH,                "",                 false,      "video",                "enter path to video"},
+	{META_MARQUEE,     "marquee",     MD_PATH,                "",                 false,      "marquee",              "enter path to marquee"},
+	{META_RATING,      "rating",      MD_RATING,              "0.000000",         false,      "rating",               "enter rating"},
+	{META_RELEASEDATE, "releasedate", MD_DATE,                "not-a-date-time",  false,      "release date",         "enter release date"},
+	{META_DEVELOPER,   "developer",   MD_STRING,              "unknown",          false,      "developer",            "enter game developer"},
+	{META_PUBLISHER,   "publisher",   MD_STRING,              "unknown",          false,      "publisher",            "enter game publisher"},
+	{META_GENRE,       "genre",       MD_STRING,              "unknown",          false,      "genre",                "enter game genre"},
+	{META_PLAYERS,     "players",     MD_INT,                 "1",                false,      "players",              "enter number of players"}
 };
 const std::vector<MetaDataDecl> folderMDD(folderDecls, folderDecls + sizeof(folderDecls) / sizeof(folderDecls[0]));
 
@@ -59,16 +63,80 @@ const std::vector<MetaDataDecl>& getMDDByType(MetaDataListType type)
 }
 
 
+static std::unordered_map<std::string, MetaDataId> createMetaDataIds()
+{
+	// every field is declared for games
+	std::unordered_map<std::string, MetaDataId> ids;
+	for(auto iter = gameMDD.cbegin(); iter != gameMDD.cend(); iter++)
+		ids[iter->key] = iter->id;
+
+	return ids;
+}
+
+static std::vector<MetaDataType> createMetaDataTypes()
+{
+	std::vector<MetaDataType> types(META_COUNT, MD_STRING);
+	for(auto iter = gameMDD.cbegin(); iter != gameMDD.cend(); iter++)
+		types[iter->id] = iter->type;
+
+	return types;
+}
+
+MetaDataId getMetaDataId(const std::string& key)
+{
+	static const std::unordered_map<std::string, MetaDataId> ids = createMetaDataIds();
+
+	auto it = ids.find(key);
+	return (it != ids.cend()) ? it->second : META_COUNT;
+}
+
+static std::vector<const std::string*> createSharedDefaults()
+{
+	std::vector<const std::string*> defaults(META_COUNT, nullptr);
+	for(auto iter = gameMDD.cbegin(); iter != gameMDD.cend(); iter++)
+	{
+		if(iter->id >= META_FIRST_SHARED)
+			defaults[iter->id] = StringPool::intern(iter->defaultValue);
+	}
+
+	return defaults;
+}
+
+// the type of every slot, to know how its value is parsed
+static MetaDataType getMetaDataType(MetaDataId id)
+{
+	static const std::vector<MetaDataType> types = createMetaDataTypes();
+	return types[id];
+}
+
+// defaults are the same for games and folders
+static const std::string* getSharedDefault(MetaDataId id)
+{
+	static const std::vector<const std::string*> defaults = createSharedDefaults();
+	return defaults[id];
+}
+
+// shared by all lists, so two lists only ever have the same revision if one is a copy of the other
+static std::atomic<unsigned int> sRevision(0);
 
 MetaDataList::MetaDataList(MetaDataListType type)
-	: mType(type), mWasChanged(false)
+	: mType(type), mRevision(0), mWasChanged(false)
 {
+	for(int i = 0; i < META_COUNT; i++)
+		mNumbers[i].asInt = 0;
+
+	// fields that aren't declared for this type stay empty
+	static const std::string* empty = StringPool::intern("");
+	for(int i = 0; i < META_COUNT - META_FIRST_SHARED; i++)
+		mShared[i] = empty;
+	for(int i = 0; i < META_GENRE - META_DEVELOPER + 1; i++)
+		mSortKeys[i] = empty;
+
 	const std::vector<MetaDataDecl>& mdd = getMDD();
 	for(auto iter = mdd.cbegin(); iter != mdd.cend(); iter++)
-		set(iter->key, iter->defaultValue);
+		set(iter->id, iter->defaultValue);
 }
 
-
 MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo)
 {
 	MetaDataList mdl(type);
@@ -86,58 +154,209 @@ MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node&
 			{
 				value = Utils::FileSystem::resolveRelativePath2(value, relativeTo, true);
 			}
-			mdl.set(iter->key, value);
+			mdl.set(iter->id, value);
 		}else{
-			mdl.set(iter->key, iter->defaultValue);
+			mdl.set(iter->id, iter->defaultValue);
 		}
 	}
 
 	return mdl;
 }
 
+void MetaDataList::assignFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo)
+{
+	if(type != mType)
+	{
+		// folders are parsed as games, their name is kept like below when the node has none
+		std::string name;
+		name.swap(mValues[META_NAME]);
+		*this = MetaDataList(type);
+		mValues[META_NAME].swap(name);
+	}
+
+	const std::vector<MetaDataDecl>& mdd = getMDD();
+
+	for(auto iter = mdd.cbegin(); iter != mdd.cend(); iter++)
+	{
+		pugi::xml_node md = node.child(iter->key.c_str());
+		const char* text = md ? md.text().get() : nullptr;
+
+		if(iter->id >= META_FIRST_SHARED)
+		{
+			mShared[iter->id - META_FIRST_SHARED] = text ? StringPool::intern(text) : getSharedDefault(iter->id);
+			updateNumber(iter->id);
+			updateSortKey(iter->id);
+			continue;
+		}
+
+		std::string& value = mValues[iter->id];
+		if(iter->id == META_NAME)
+		{
+			// keep the default name if the gamelist doesn't have one
+			if(text && text[0] != '\0')
+				value.assign(text);
+		}
+		else if(!text)
+		{
+			value.assign(iter->defaultValue);
+		}
+		else if(iter->type == MD_PATH)
+		{
+			// if it's a path, resolve relative paths
+			Utils::FileSystem::resolveRelativePath(text, relativeTo, true, value);
+		}
+		else
+		{
+			value.assign(text);
+		}
+
+		updateNumber(iter->id);
+		updateSortKey(iter->id);
+	}
+
+	mRevision = ++sRevision;
+	mWasChanged = true;
+}
+
 void MetaDataList::appendToXML(pugi::xml_node& parent, bool ignoreDefaults, const std::string& relativeTo) const
 {
 	const std::vector<MetaDataDecl>& mdd = getMDD();
 
 	for(auto mddIter = mdd.cbegin(); mddIter != mdd.cend(); mddIter++)
 	{
-		auto mapIter = mMap.find(mddIter->key);
-		if(mapIter != mMap.cend())
-		{
-			// we have this value!
-			// if it's just the default (and we ignore defaults), don't write it
-			if(ignoreDefaults && mapIter->second == mddIter->defaultValue)
-				continue;
+		// if it's just the default (and we ignore defaults), don't write it
+		if(ignoreDefaults && isDefault(mddIter->id))
+			continue;
+
+		// try and make paths relative if we can
+		std::string value = get(mddIter->id);
+		if (mddIter->type == MD_PATH)
+			value = Utils::FileSystem::createRelativePath(value, relativeTo, true);
+
+		parent.append_child(mddIter->key.c_str()).text().set(value.c_str());
+	}
+}
+
+void MetaDataList::set(MetaDataId id, const std::string& value)
+{
+	if(id < META_FIRST_SHARED)
+		mValues[id] = value;
+	else
+		mShared[id - META_FIRST_SHARED] = StringPool::intern(value);
+
+	updateNumber(id);
+	updateSortKey(id);
+	mRevision = ++sRevision;
+	mWasChanged = true;
+}
+
+int MetaDataList::getInt(MetaDataId id) const
+{
+	return (getMetaDataType(id) == MD_INT) ? mNumbers[id].asInt : atoi(get(id).c_str());
+}
+
+float MetaDataList::getFloat(MetaDataId id) const
+{
+	const MetaDataType type = getMetaDataType(id);
+	return ((type == MD_FLOAT) || (type == MD_RATING)) ? mNumbers[id].asFloat : (float)atof(get(id).c_str());
+}
+
+bool MetaDataList::getBool(MetaDataId id) const
+{
+	return (getMetaDataType(id) == MD_BOOL) ? mNumbers[id].asBool : (get(id) == "true");
+}
+
+bool MetaDataList::isDefault(MetaDataId id) const
+{
+	if(id >= META_FIRST_SHARED)
+		return mShared[id - META_FIRST_SHARED] == getSharedDefault(id);
 
-			// try and make paths relative if we can
-			std::string value = mapIter->second;
-			if (mddIter->type == MD_PATH)
-				value = Utils::FileSystem::createRelativePath(value, relativeTo, true);
+	// every field is declared for games, with the same default as for folders
+	for(auto iter = gameMDD.cbegin(); iter != gameMDD.cend(); iter++)
+	{
+		if(iter->id == id)
+			return mValues[id] == iter->defaultValue;
+	}
+
+	return mValues[id].empty();
+}
+
+void MetaDataList::addPooledReferences(StringPool::Stats& stats) const
+{
+	for(int i = 0; i < META_COUNT - META_FIRST_SHARED; i++)
+		StringPool::addReference(mShared[i], stats);
+	for(int i = 0; i < META_GENRE - META_DEVELOPER + 1; i++)
+		StringPool::addReference(mSortKeys[i], stats);
+}
 
-			parent.append_child(mapIter->first.c_str()).text().set(value.c_str());
+void MetaDataList::updateNumber(MetaDataId id)
+{
+	switch(getMetaDataType(id))
+	{
+		case MD_INT:    { mNumbers[id].asInt   = atoi(get(id).c_str());        } break;
+		case MD_FLOAT:
+		case MD_RATING: { mNumbers[id].asFloat = (float)atof(get(id).c_str()); } break;
+		case MD_BOOL:   { mNumbers[id].asBool  = (get(id) == "true");          } break;
+		default: break;
+	}
+}
+
+void MetaDataList::updateSortKey(MetaDataId id)
+{
+	switch(id)
+	{
+		case META_NAME:
+		case META_SORTNAME:
+		{
+			const std::string& sortName = get(META_SORTNAME);
+			mNameSortKey = Utils::String::toUpper(sortName.empty() ? get(META_NAME) : sortName);
 		}
+		break;
+
+		case META_DEVELOPER:
+		case META_PUBLISHER:
+		case META_GENRE: { mSortKeys[id - META_DEVELOPER] = StringPool::intern(Utils::String::toUpper(get(id))); } break;
+
+		default: break;
 	}
 }
 
 void MetaDataList::set(const std::string& key, const std::string& value)
 {
-	mMap[key] = value;
-	mWasChanged = true;
+	const MetaDataId id = getMetaDataId(key);
+	if(id == META_COUNT)
+	{
+		LOG(LogError) << "Unknown metadata \"" << key << "\"";
+		return;
+	}
+
+	set(id, value);
 }
 
 const std::string& MetaDataList::get(const std::string& key) const
 {
-	return mMap.at(key);
+	static const std::string empty;
+
+	const MetaDataId id = getMetaDataId(key);
+	if(id == META_COUNT)
+	{
+		LOG(LogError) << "Unknown metadata \"" << key << "\"";
+		return empty;
+	}
+
+	return get(id);
 }
 
 int MetaDataList::getInt(const std::string& key) const
 {
-	return atoi(get(key).c_str());
+	const MetaDataId id = getMetaDataId(key);
+	return (id != META_COUNT) ? getInt(id) : 0;
 }
 
 float MetaDataList::getFloat(const std::string& key) const
 {
-	return (float)atof(get(key).c_str());
+	const MetaDataId id = getMetaDataId(key);
+	return (id != META_COUNT) ? getFloat(id) : 0.0f;
 }
 
 bool MetaDataList::wasChanged() const
@@ -2,6 +2,7 @@
 #ifndef ES_APP_META_DATA_H
 #define ES_APP_META_DATA_H
 
+#include "StringPool.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -24,8 +25,38 @@ enum MetaDataType
 	MD_TIME //used for lastplayed
 };
 
+// Every field a MetaDataList can hold, used as its slot index. Folders only use some of them.
+enum MetaDataId
+{
+	// mostly different for every game, each list keeps its own copy
+	META_NAME,
+	META_SORTNAME,
+	META_DESC,
+	META_IMAGE,
+	META_VIDEO,
+	META_MARQUEE,
+	META_THUMBNAIL,
+	META_LASTPLAYED,
+
+	// only a few distinct values across all games, shared through the StringPool
+	META_RATING,
+	META_RELEASEDATE,
+	META_DEVELOPER,
+	META_PUBLISHER,
+	META_GENRE,
+	META_PLAYERS,
+	META_FAVORITE,
+	META_HIDDEN,
+	META_KIDGAME,
+	META_PLAYCOUNT,
+
+	META_COUNT,
+	META_FIRST_SHARED = META_RATING
+};
+
 struct MetaDataDecl
 {
+	MetaDataId id;
 	std::string key;
 	MetaDataType type;
 	std::string defaultValue;
@@ -42,14 +73,36 @@ enum MetaDataListType
 
 const std::vector<MetaDataDecl>& getMDDByType(MetaDataListType type);
 
+// META_COUNT if key isn't a metadata field
+MetaDataId getMetaDataId(const std::string& key);
+
 class MetaDataList
 {
 public:
 	static MetaDataList createFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo);
+	// same as createFromXML but updates this list in place, values are copied once from the parsed document
+	// and the current name is kept if the node has none, relativeTo must be a generic path
+	void assignFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo);
 	void appendToXML(pugi::xml_node& parent, bool ignoreDefaults, const std::string& relativeTo) const;
 
 	MetaDataList(MetaDataListType type);
 
+	// values are kept in one slot per MetaDataId, numbers and flags are parsed once when they're set
+	void set(MetaDataId id, const std::string& value);
+
+	inline const std::string& get(MetaDataId id) const { return (id < META_FIRST_SHARED) ? mValues[id] : *mShared[id - META_FIRST_SHARED]; }
+	int getInt(MetaDataId id) const;
+	float getFloat(MetaDataId id) const;
+	bool getBool(MetaDataId id) const;
+	bool isDefault(MetaDataId id) const; // a pointer comparison for shared values
+
+	// upper-cased copies the sorts compare, kept up to date by set(), only for META_NAME (the sort name
+	// if there is one, the name otherwise), META_DEVELOPER, META_PUBLISHER and META_GENRE
+	inline const std::string& getSortKey(MetaDataId id) const { return (id == META_NAME) ? mNameSortKey : *mSortKeys[id - META_DEVELOPER]; }
+
+	void addPooledReferences(StringPool::Stats& stats) const; // the shared values and sort keys
+
+	// same as above by key, slower as the key has to be looked up first
 	void set(const std::string& key, const std::string& value);
 
 	const std::string& get(const std::string& key) const;
@@ -59,12 +112,28 @@ public:
 	bool wasChanged() const;
 	void resetChangedFlag();
 
+	// changes whenever a value is set, a copy keeps the revision of the list it was copied from
+	inline unsigned int getRevision() const { return mRevision; }
+
 	inline MetaDataListType getType() const { return mType; }
 	inline const std::vector<MetaDataDecl>& getMDD() const { return getMDDByType(getType()); }
 
 private:
+	void updateNumber(MetaDataId id);
+	void updateSortKey(MetaDataId id);
+
 	MetaDataListType mType;
-	std::map<std::string, std::string> mMap;
+	unsigned int mRevision;
+	std::string mValues[META_FIRST_SHARED];
+	const std::string* mShared[META_COUNT - META_FIRST_SHARED];
+	union
+	{
+		int   asInt;   // MD_INT
+		float asFloat; // MD_FLOAT, MD_RATING
+		bool  asBool;  // MD_BOOL
+	} mNumbers[META_COUNT];
+	std::string mNameSortKey;
+	const std::string* mSortKeys[META_GENRE - META_DEVELOPER + 1]; // interned like the values they're made of
 	bool mWasChanged;
 };
 
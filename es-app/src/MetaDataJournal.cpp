@@ -0,0 +1,266 @@
+#include "MetaDataJournal.h"
+
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "Log.h"
+#include "SystemData.h"
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <io.h>
+#else // _WIN32
+#include <unistd.h>
+#endif // _WIN32
+
+// bump whenever the layout below changes, an older journal is then ignored
+#define JOURNAL_MAGIC   "ESMDJRNL"
+#define JOURNAL_VERSION 2
+
+// Layout, all integers in native byte order like the gamelist snapshot:
+//   magic, u32 version
+//   record...
+// record:
+//   u32 size of the rest of the record, u32 checksum of the rest of the record,
+//   string path, u32 value count, { string key, string value }...
+// strings are a u32 length followed by the bytes, without terminator. A record cut short by a crash or
+// failing its checksum is dropped along with everything after it, and the journal is cut back to the
+// records before it so the next record is appended right behind them.
+
+// appending and removing can happen on different threads
+static std::mutex sJournalMutex;
+
+static void appendU32(std::string& buffer, uint32_t value)
+{
+	buffer.append((const char*)&value, sizeof(value));
+}
+
+static void appendString(std::string& buffer, const std::string& value)
+{
+	appendU32(buffer, (uint32_t)value.size());
+	buffer.append(value);
+}
+
+// FNV-1a, only meant to catch torn or misframed records
+static uint32_t getChecksum(const char* data, size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for(size_t i = 0; i < size; ++i)
+	{
+		hash ^= (unsigned char)data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static bool truncateJournal(FILE* journal, long long size)
+{
+	fflush(journal);
+#if defined(_WIN32)
+	return _chsize_s(_fileno(journal), size) == 0;
+#else // _WIN32
+	return ftruncate(fileno(journal), (off_t)size) == 0;
+#endif // _WIN32
+}
+
+static bool readU32(const char*& cursor, const char* end, uint32_t& value)
+{
+	if(sizeof(value) > (size_t)(end - cursor))
+		return false;
+
+	memcpy(&value, cursor, sizeof(value));
+	cursor += sizeof(value);
+	return true;
+}
+
+static bool readString(const char*& cursor, const char* end, std::string& value)
+{
+	uint32_t size;
+	if(!readU32(cursor, end, size) || (size > (size_t)(end - cursor)))
+		return false;
+
+	value.assign(cursor, size);
+	cursor += size;
+	return true;
+}
+
+bool appendMetaDataJournal(SystemData* system, const FileData* file)
+{
+	const std::vector<MetaDataDecl>& mdd = file->metadata.getMDD();
+	uint32_t count = 0;
+	for(auto it = mdd.cbegin(); it != mdd.cend(); ++it)
+	{
+		if(it->isStatistic || (it->id == META_FAVORITE))
+			++count;
+	}
+
+	std::string record;
+	appendString(record, file->getPath());
+	appendU32(record, count);
+	for(auto it = mdd.cbegin(); it != mdd.cend(); ++it)
+	{
+		if(it->isStatistic || (it->id == META_FAVORITE))
+		{
+			appendString(record, it->key);
+			appendString(record, file->metadata.get(it->id));
+		}
+	}
+
+	const std::string path = system->getJournalPath();
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(path));
+
+	std::unique_lock<std::mutex> lock(sJournalMutex);
+
+	FILE* journal = fopen(path.c_str(), "ab");
+	if(!journal)
+	{
+		LOG(LogError) << "Error - could not open metadata journal \"" << path << "\"";
+		return false;
+	}
+
+	// a new journal starts with its header
+	std::string buffer;
+	fseek(journal, 0, SEEK_END);
+	const long long previousSize = ftell(journal);
+	if(previousSize == 0)
+	{
+		buffer.append(JOURNAL_MAGIC);
+		appendU32(buffer, JOURNAL_VERSION);
+	}
+	appendU32(buffer, (uint32_t)record.size());
+	appendU32(buffer, getChecksum(record.data(), record.size()));
+	buffer.append(record);
+
+	// the record is tiny, flushing it to the disk costs far less than rewriting the gamelist
+	bool written = (fwrite(buffer.data(), 1, buffer.size(), journal) == buffer.size());
+	written = written && (fflush(journal) == 0);
+#if defined(_WIN32)
+	written = written && (_commit(_fileno(journal)) == 0);
+#else // _WIN32
+	written = written && (fsync(fileno(journal)) == 0);
+#endif // _WIN32
+
+	// whatever part of the record made it to the file would garble the records appended after it
+	if(!written && (previousSize >= 0) && !truncateJournal(journal, previousSize))
+		LOG(LogError) << "Error - could not cut metadata journal \"" << path << "\" back to its last complete record";
+
+	written = (fclose(journal) == 0) && written;
+
+	if(!written)
+		LOG(LogError) << "Error - could not write metadata journal \"" << path << "\"";
+
+	return written;
+}
+
+bool replayMetaDataJournal(SystemData* system)
+{
+	const std::string path = system->getJournalPath();
+
+	std::unique_lock<std::mutex> lock(sJournalMutex);
+
+	FILE* journal = fopen(path.c_str(), "r+b");
+	if(!journal)
+		return false;
+
+	std::string data;
+	fseek(journal, 0, SEEK_END);
+	long size = ftell(journal);
+	fseek(journal, 0, SEEK_SET);
+	if(size > 0)
+	{
+		data.resize((size_t)size);
+		if(fread(&data[0], 1, (size_t)size, journal) != (size_t)size)
+		{
+			LOG(LogError) << "Error - could not read metadata journal \"" << path << "\"";
+			fclose(journal);
+			return false;
+		}
+	}
+
+	const size_t magicSize = strlen(JOURNAL_MAGIC);
+	const char* cursor = data.data() + magicSize;
+	const char* end = data.data() + data.size();
+	uint32_t version;
+	if((data.size() < magicSize) || (data.compare(0, magicSize, JOURNAL_MAGIC) != 0) || !readU32(cursor, end, version) || (version != JOURNAL_VERSION))
+	{
+		// new records couldn't be appended to it either, the next one starts a new journal
+		LOG(LogWarning) << "Removing metadata journal \"" << path << "\", it was written by another version or its header is incomplete";
+		fclose(journal);
+		Utils::FileSystem::removeFile(path);
+		return false;
+	}
+
+	int numReplayed = 0;
+	const char* validEnd = cursor; // behind the last complete record
+	std::string filePath;
+	std::string key;
+	std::string value;
+	while(cursor < end)
+	{
+		uint32_t recordSize;
+		uint32_t checksum;
+		uint32_t count;
+		if(!readU32(cursor, end, recordSize) || !readU32(cursor, end, checksum) || (recordSize > (size_t)(end - cursor)) || (checksum != getChecksum(cursor, recordSize)))
+		{
+			// the records can't be told apart past this point, the journal is cut back to the last good one
+			const long long validSize = (long long)(validEnd - data.data());
+			LOG(LogWarning) << "Metadata journal \"" << path << "\" has an incomplete or damaged record, dropping it and the " << (end - validEnd) << " bytes after it";
+			if(!truncateJournal(journal, validSize))
+				LOG(LogError) << "Error - could not cut metadata journal \"" << path << "\" back to its last complete record";
+			break;
+		}
+
+		const char* recordEnd = cursor + recordSize;
+		validEnd = recordEnd;
+		if(!readString(cursor, recordEnd, filePath) || !readU32(cursor, recordEnd, count))
+		{
+			cursor = recordEnd;
+			continue;
+		}
+
+		// games removed from the rom folder since are skipped
+		FileData* file = system->findFile(filePath);
+		for(uint32_t i = 0; (i < count) && readString(cursor, recordEnd, key) && readString(cursor, recordEnd, value); ++i)
+		{
+			const MetaDataId id = getMetaDataId(key);
+			if(file && (file->getType() == GAME) && (id != META_COUNT))
+				file->metadata.set(id, value);
+		}
+
+		cursor = recordEnd;
+		++numReplayed;
+	}
+	fclose(journal);
+
+	LOG(LogInfo) << "Replayed " << numReplayed << " metadata changes of system \"" << system->getName() << "\" from its journal";
+	return numReplayed > 0;
+}
+
+static long long getJournalSize(const std::string& path)
+{
+	FILE* journal = fopen(path.c_str(), "rb");
+	if(!journal)
+		return 0;
+
+	fseek(journal, 0, SEEK_END);
+	long long size = ftell(journal);
+	fclose(journal);
+	return size;
+}
+
+long long getMetaDataJournalSize(SystemData* system)
+{
+	std::unique_lock<std::mutex> lock(sJournalMutex);
+	return getJournalSize(system->getJournalPath());
+}
+
+void removeMetaDataJournal(const std::string& path, long long size)
+{
+	std::unique_lock<std::mutex> lock(sJournalMutex);
+
+	const long long currentSize = getJournalSize(path);
+	if((currentSize > 0) && (currentSize <= size))
+		Utils::FileSystem::removeFile(path);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef ES_APP_META_DATA_JOURNAL_H
+#define ES_APP_META_DATA_JOURNAL_H
+
+#include <string>
+
+class FileData;
+class SystemData;
+
+// Play statistics (the statistic metadata, like playcount and lastplayed) and the favorite flag change on every
+// launch or toggle. Instead of rewriting the whole gamelist each time, the new values of the game are appended to
+// a small journal of the system and flushed to disk right away. The journal is replayed when the system is loaded
+// and removed once its changes made it into the gamelist.
+
+// Returns false if the values couldn't be written, the caller should save the gamelist instead.
+bool appendMetaDataJournal(SystemData* system, const FileData* file);
+
+// Applies the journal of a system to its freshly loaded tree, the replayed values are flagged as changed so the next
+// gamelist update writes them. Returns true if there was anything to replay.
+bool replayMetaDataJournal(SystemData* system);
+
+// 0 if there is no journal, recorded along with the changes that are about to be written to the gamelist.
+long long getMetaDataJournalSize(SystemData* system);
+
+// Once the gamelist has been written, a journal that grew past size in the meantime holds newer changes and is kept.
+// Can be called from any thread.
+void removeMetaDataJournal(const std::string& path, long long size);
+
+#endif // ES_APP_META_DATA_JOURNAL_H
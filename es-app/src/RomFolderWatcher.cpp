@@ -0,0 +1,316 @@
+#include "RomFolderWatcher.h"
+
+#include "utils/FileSystemUtil.h"
+#include "views/gamelist/IGameListView.h"
+#include "views/ViewController.h"
+#include "CollectionSystemManager.h"
+#include "FileData.h"
+#include "Log.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include "Window.h"
+#include <vector>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+RomFolderWatcher* RomFolderWatcher::sInstance = nullptr;
+
+void RomFolderWatcher::init()
+{
+	if(!sInstance)
+		sInstance = new RomFolderWatcher();
+
+} // init
+
+void RomFolderWatcher::deinit()
+{
+	if(sInstance)
+	{
+		delete sInstance;
+		sInstance = nullptr;
+	}
+
+} // deinit
+
+RomFolderWatcher* RomFolderWatcher::getInstance()
+{
+	if(!sInstance)
+		sInstance = new RomFolderWatcher();
+
+	return sInstance;
+
+} // getInstance
+
+RomFolderWatcher::RomFolderWatcher() : mFd(-1), mUnavailable(false)
+{
+} // RomFolderWatcher
+
+RomFolderWatcher::~RomFolderWatcher()
+{
+	stop();
+
+} // ~RomFolderWatcher
+
+void RomFolderWatcher::start()
+{
+#if defined(__linux__)
+	mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(mFd < 0)
+	{
+		LOG(LogError) << "Error - could not initialize inotify, rom folders won't be watched";
+		mUnavailable = true;
+	}
+	else
+		LOG(LogInfo) << "Watching rom folders for changes";
+#endif
+
+} // start
+
+void RomFolderWatcher::stop()
+{
+#if defined(__linux__)
+	if(mFd >= 0)
+		close(mFd);
+#endif
+
+	mFd = -1;
+	mWatches.clear();
+	mWatchedSystems.clear();
+	mChangedSystems.clear();
+	mPendingChanges.clear();
+
+} // stop
+
+void RomFolderWatcher::update(Window* window)
+{
+#if defined(__linux__)
+	if(!Settings::getInstance()->getBool("WatchRomFolders"))
+	{
+		if(mFd >= 0)
+			stop();
+
+		return;
+	}
+
+	// don't retry every frame if inotify isn't available
+	if((mFd < 0) && !mUnavailable)
+		start();
+
+	if(mFd < 0)
+		return;
+
+	// with LazySystemLoading a system is only watched once its games are loaded
+	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
+	{
+		if(!(*it)->isCollection() && (*it)->isGameListLoaded() && (mWatchedSystems.find(*it) == mWatchedSystems.cend()))
+			watchSystem(*it);
+	}
+
+	// a read returns as many complete events as fit in the buffer, which has to be aligned for them
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	ssize_t length;
+	while((length = read(mFd, buffer, sizeof(buffer))) > 0)
+	{
+		const char* ptr = buffer;
+		while(ptr < buffer + length)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if(event->mask & IN_Q_OVERFLOW)
+			{
+				LOG(LogWarning) << "Too many changes in the rom folders at once, some of them were missed";
+				continue;
+			}
+
+			// the folder itself is gone or its watch was removed
+			if(event->mask & IN_IGNORED)
+			{
+				mWatches.erase(event->wd);
+				continue;
+			}
+
+			if(event->len == 0)
+				continue;
+
+			if(!(event->mask & (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM)))
+				continue;
+
+			const bool added = (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+			auto range = mWatches.equal_range(event->wd);
+			for(auto it = range.first; it != range.second; ++it)
+				mPendingChanges.push_back(Change{ it->second.system, it->second.path + "/" + event->name, added });
+		}
+	}
+
+	// the kernel queue is drained above in any case so it can't overflow, the changes themselves wait
+	// while a menu, a popup or the screensaver could still be holding a node that would be deleted
+	if((window->peekGui() != ViewController::get()) || window->isScreenSaverActive())
+		return;
+
+	while(!mPendingChanges.empty())
+	{
+		// copied, handling a change adds or removes watches
+		const Change change = mPendingChanges.front();
+		mPendingChanges.pop_front();
+
+		if(change.added)
+			onFileAdded(change.system, change.path);
+		else
+			onFileRemoved(change.system, change.path);
+	}
+
+	// new games only need a single refresh per system, however many arrived at once
+	for(auto it = mChangedSystems.cbegin(); it != mChangedSystems.cend(); ++it)
+		ViewController::get()->onFileChanged((*it)->getRootFolder(), FILE_ADDED);
+
+	mChangedSystems.clear();
+#endif
+
+} // update
+
+void RomFolderWatcher::watchSystem(SystemData* system)
+{
+	mWatchedSystems.insert(system);
+
+	addWatch(system, system->getStartPath());
+
+	system->getRootFolder()->visitFilesRecursive(FOLDER, false, [&](FileData* folder) -> bool { addWatch(system, folder->getPath()); return true; });
+
+} // watchSystem
+
+void RomFolderWatcher::addWatch(SystemData* system, const std::string& path)
+{
+#if defined(__linux__)
+	int wd = inotify_add_watch(mFd, path.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+	if(wd < 0)
+	{
+		LOG(LogWarning) << "Could not watch folder \"" << path << "\"";
+		return;
+	}
+
+	auto range = mWatches.equal_range(wd);
+	for(auto it = range.first; it != range.second; ++it)
+	{
+		if((it->second.system == system) && (it->second.path == path))
+			return;
+	}
+
+	mWatches.insert(std::make_pair(wd, Watch{ system, path }));
+#endif
+
+} // addWatch
+
+void RomFolderWatcher::removeWatches(SystemData* system, const std::string& path)
+{
+#if defined(__linux__)
+	std::set<int> removed;
+	for(auto it = mWatches.begin(); it != mWatches.end(); )
+	{
+		const std::string& watched = it->second.path;
+		if((it->second.system == system) && (watched.compare(0, path.size(), path) == 0) && ((watched.size() == path.size()) || (watched[path.size()] == '/')))
+		{
+			removed.insert(it->first);
+			it = mWatches.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// a folder moved away is still watched by the kernel, stop it unless another system shares it
+	for(auto it = removed.cbegin(); it != removed.cend(); ++it)
+	{
+		if(mWatches.find(*it) == mWatches.cend())
+			inotify_rm_watch(mFd, *it);
+	}
+#endif
+
+} // removeWatches
+
+void RomFolderWatcher::onFileAdded(SystemData* system, const std::string& path)
+{
+	// watch a new folder before scanning it, so nothing created in the meantime is missed
+	if(Utils::FileSystem::isDirectory(path) && (Settings::getInstance()->getBool("ShowHiddenFiles") || !Utils::FileSystem::isHidden(path)))
+		addWatch(system, path);
+
+	std::vector<SnapshotFolder> folders;
+	FileData* file = system->addFile(path, folders);
+
+	for(auto it = folders.cbegin(); it != folders.cend(); ++it)
+		addWatch(system, it->path);
+
+	if(!file)
+		return;
+
+	LOG(LogInfo) << "Added \"" << path << "\" to system \"" << system->getName() << "\"";
+
+	if(file->getType() == GAME)
+		CollectionSystemManager::get()->refreshCollectionSystems(file);
+	else
+		file->visitFilesRecursive(GAME, false, [](FileData* game) -> bool { CollectionSystemManager::get()->refreshCollectionSystems(game); return true; });
+
+	mChangedSystems.insert(system);
+
+} // onFileAdded
+
+// FileData doesn't delete its children, a game removes itself from the filter index when it's deleted
+static void deleteChildren(FileData* folder)
+{
+	while(!folder->getChildren().empty())
+	{
+		FileData* child = folder->getChildren().back();
+		if(child->getType() == FOLDER)
+			deleteChildren(child);
+
+		delete child;
+	}
+
+} // deleteChildren
+
+void RomFolderWatcher::onFileRemoved(SystemData* system, const std::string& path)
+{
+	removeWatches(system, path);
+
+	FileData* file = system->findFile(path);
+	if(!file || (file == system->getRootFolder()))
+		return;
+
+	LOG(LogInfo) << "Removed \"" << path << "\" from system \"" << system->getName() << "\"";
+
+	if(file->getType() == GAME)
+		CollectionSystemManager::get()->deleteCollectionFiles(file);
+	else
+		file->visitFilesRecursive(GAME, false, [](FileData* game) -> bool { CollectionSystemManager::get()->deleteCollectionFiles(game); return true; });
+
+	if(!ViewController::get()->hasGameListView(system))
+	{
+		deleteChildren(file);
+		delete file;
+		return;
+	}
+
+	IGameListView* view = ViewController::get()->getGameListView(system).get();
+
+	// leave a removed folder first if it's currently open, the view keeps pointers to the folders it went through
+	if(file->getType() == FOLDER)
+	{
+		for(FileData* parent = view->getCursor()->getParent(); parent; parent = parent->getParent())
+		{
+			if(parent == file)
+			{
+				view->setCursor(file);
+				break;
+			}
+		}
+
+		deleteChildren(file);
+	}
+
+	// moves the cursor away if needed, deletes the node and refreshes the view
+	view->remove(file, false);
+
+} // onFileRemoved
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef ES_APP_ROM_FOLDER_WATCHER_H
+#define ES_APP_ROM_FOLDER_WATCHER_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+
+class FileData;
+class SystemData;
+class Window;
+
+// Keeps the game trees in sync with the rom folders while ES is running when WatchRomFolders is set.
+// Games and folders that appear or disappear are added to or removed from their system one by one,
+// only the gamelist views of the affected systems are refreshed. Only implemented with inotify (Linux).
+// Menus, popups and the screensaver hold raw FileData pointers, so the changes wait until they're closed.
+class RomFolderWatcher
+{
+public:
+
+	static void              init       ();
+	static void              deinit     ();
+	static RomFolderWatcher* getInstance();
+
+	// called once per frame from the main loop, applies the changes that happened since the last call without blocking
+	// unless anything is shown on top of the gamelists of window
+	void update(Window* window);
+
+private:
+
+	struct Watch
+	{
+		SystemData* system;
+		std::string path;
+	};
+
+	struct Change
+	{
+		SystemData* system;
+		std::string path;
+		bool added;
+	};
+
+	 RomFolderWatcher();
+	~RomFolderWatcher();
+
+	static RomFolderWatcher* sInstance;
+
+	void start();
+	void stop();
+
+	void watchSystem(SystemData* system);
+	void addWatch(SystemData* system, const std::string& path);
+	void removeWatches(SystemData* system, const std::string& path); // path and every folder below it
+
+	void onFileAdded(SystemData* system, const std::string& path);
+	void onFileRemoved(SystemData* system, const std::string& path);
+
+	int                          mFd;
+	bool                         mUnavailable;
+	std::multimap<int, Watch>    mWatches; // several systems can share a rom folder, inotify then returns the same descriptor
+	std::set<SystemData*>        mWatchedSystems;
+	std::set<SystemData*>        mChangedSystems; // systems that got new games during the current update
+	std::deque<Change>           mPendingChanges; // read from inotify but not applied yet, in the order they happened
+
+}; // RomFolderWatcher
+
+#endif // ES_APP_ROM_FOLDER_WATCHER_H
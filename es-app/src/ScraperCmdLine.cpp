@@ -147,7 +147,7 @@ int run_scraper_cmdline()
 	std::shared_ptr<Scraper> scraper = Settings::getInstance()->getScraper();
 	for(auto sysIt = systems.cbegin(); sysIt != systems.cend(); sysIt++)
 	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+		const std::vector<FileData*>& files = (*sysIt)->getGames();
 
 		ScraperSearchParams params;
 		params.system = (*sysIt);
@@ -244,7 +244,7 @@ int run_scraper_cmdline()
 
 	for(auto sysIt = systems.cbegin(); sysIt != systems.cend(); sysIt++)
 	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+		const std::vector<FileData*>& files = (*sysIt)->getGames();
 
 		for(auto gameIt = files.cbegin(); gameIt != files.cend(); gameIt++)
 		{
@@ -0,0 +1,137 @@
+#include "StartupTasks.h"
+
+#include "Log.h"
+
+StartupTasks::StartupTasks(bool parallel) : mParallel(parallel), mBegin(std::chrono::steady_clock::now()), mLastMainTask(nullptr)
+{
+}
+
+StartupTasks::~StartupTasks()
+{
+	waitAll();
+}
+
+long long StartupTasks::now() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mBegin).count();
+}
+
+StartupTasks::Task* StartupTasks::createTask(const std::string& name, const std::vector<std::string>& dependencies)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	Task* task = new Task();
+	task->name = name;
+	task->start = 0;
+	task->end = 0;
+	task->done = false;
+
+	// dependencies can only name stages added before, which also rules out cycles
+	for(auto it = dependencies.cbegin(); it != dependencies.cend(); ++it)
+	{
+		Task* dependency = nullptr;
+		for(auto taskIt = mTasks.cbegin(); taskIt != mTasks.cend(); ++taskIt)
+		{
+			if((*taskIt)->name == *it)
+				dependency = taskIt->get();
+		}
+
+		if(dependency)
+			task->dependencies.push_back(dependency);
+		else
+			LOG(LogWarning) << "Startup stage \"" << name << "\" depends on unknown stage \"" << *it << "\"";
+	}
+
+	// without workers every stage simply follows the previous one
+	if(!mParallel && !mTasks.empty())
+		task->dependencies.push_back(mTasks.back().get());
+
+	mTasks.push_back(std::unique_ptr<Task>(task));
+	return task;
+}
+
+void StartupTasks::execute(Task* task, const std::function<void()>& func)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		for(auto it = task->dependencies.cbegin(); it != task->dependencies.cend(); ++it)
+		{
+			while(!(*it)->done)
+				mTaskDone.wait(lock);
+		}
+		task->start = now();
+	}
+
+	func();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	task->end = now();
+	task->done = true;
+	mTaskDone.notify_all();
+}
+
+void StartupTasks::add(const std::string& name, const std::function<void()>& func, const std::vector<std::string>& dependencies)
+{
+	Task* task = createTask(name, dependencies);
+
+	if(mParallel)
+		mThreads.push_back(std::thread(&StartupTasks::execute, this, task, func));
+	else
+		execute(task, func);
+}
+
+void StartupTasks::run(const std::string& name, const std::function<void()>& func, const std::vector<std::string>& dependencies)
+{
+	Task* task = createTask(name, dependencies);
+
+	// the main thread runs its stages one after the other, each one waits for the previous
+	if(mLastMainTask)
+		task->dependencies.push_back(mLastMainTask);
+	mLastMainTask = task;
+
+	execute(task, func);
+}
+
+void StartupTasks::waitAll()
+{
+	for(auto it = mThreads.begin(); it != mThreads.end(); ++it)
+		it->join();
+
+	mThreads.clear();
+}
+
+void StartupTasks::logCriticalPath()
+{
+	waitAll();
+
+	if(mTasks.empty())
+		return;
+
+	for(auto it = mTasks.cbegin(); it != mTasks.cend(); ++it)
+		LOG(LogDebug) << "Startup stage \"" << (*it)->name << "\" ran from " << (*it)->start << " to " << (*it)->end << " ms";
+
+	// walk back from the stage that finished last, through the dependency each stage waited for the longest
+	Task* task = mTasks.front().get();
+	for(auto it = mTasks.cbegin(); it != mTasks.cend(); ++it)
+	{
+		if((*it)->end > task->end)
+			task = it->get();
+	}
+
+	const long long total = task->end;
+	std::string path;
+	while(task)
+	{
+		path = task->name + " (" + std::to_string(task->end - task->start) + " ms)" + (path.empty() ? "" : " -> ") + path;
+
+		Task* gate = nullptr;
+		for(auto it = task->dependencies.cbegin(); it != task->dependencies.cend(); ++it)
+		{
+			if(!gate || ((*it)->end > gate->end))
+				gate = *it;
+		}
+		task = gate;
+	}
+
+	LOG(LogInfo) << "Startup took " << total << " ms" << (mParallel ? "" : " (sequential)") << ", critical path: " << path;
+}
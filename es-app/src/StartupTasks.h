@@ -0,0 +1,56 @@
+#pragma once
+#ifndef ES_APP_STARTUP_TASKS_H
+#define ES_APP_STARTUP_TASKS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The stages of the startup and what they depend on. Stages added with add() run on worker threads when
+// parallel is set, stages passed to run() need the main thread (SDL, OpenGL) and run there in call order.
+// Every stage is timed, logCriticalPath() reports the chain of stages that made up the startup time.
+class StartupTasks
+{
+public:
+	StartupTasks(bool parallel);
+	~StartupTasks(); // waits for the workers that are still running
+
+	// starts func once the stages named in dependencies are done, on a worker thread or right away on this one if not parallel
+	void add(const std::string& name, const std::function<void()>& func, const std::vector<std::string>& dependencies = std::vector<std::string>());
+	// runs func on the calling thread once the stages named in dependencies and the previous run() stage are done
+	void run(const std::string& name, const std::function<void()>& func, const std::vector<std::string>& dependencies = std::vector<std::string>());
+
+	void waitAll();
+
+	void logCriticalPath(); // waits for all stages first
+
+private:
+	struct Task
+	{
+		std::string name;
+		std::vector<Task*> dependencies;
+		long long start; // in ms since the StartupTasks was created
+		long long end;
+		bool done;
+	};
+
+	Task* createTask(const std::string& name, const std::vector<std::string>& dependencies);
+	void execute(Task* task, const std::function<void()>& func);
+	long long now() const;
+
+	bool mParallel;
+	std::chrono::steady_clock::time_point mBegin;
+	Task* mLastMainTask;
+
+	std::vector<std::unique_ptr<Task>> mTasks;
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mTaskDone;
+};
+
+#endif // ES_APP_STARTUP_TASKS_H
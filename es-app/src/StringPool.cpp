@@ -0,0 +1,112 @@
+#include "StringPool.h"
+
+#include <deque>
+#include <mutex>
+#include <string.h>
+#include <unordered_set>
+
+// the pool is split by hash so threads loading different systems rarely wait for each other
+#define STRING_POOL_SHARDS 16
+
+// strings up to this length are stored inside std::string itself (libstdc++ small string optimization)
+#define SMALL_STRING_SIZE 15
+
+namespace
+{
+	// points at the characters of a pooled string, or at the ones looked up so a lookup doesn't need a std::string
+	struct Key
+	{
+		const char* data;
+		size_t length;
+		size_t hash;
+		const std::string* string; // nullptr while looking up
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const { return key.hash; }
+	};
+
+	struct KeyEqual
+	{
+		bool operator()(const Key& a, const Key& b) const { return (a.length == b.length) && (memcmp(a.data, b.data, a.length) == 0); }
+	};
+
+	struct Shard
+	{
+		std::mutex mutex;
+		std::unordered_set<Key, KeyHash, KeyEqual> keys;
+		std::deque<std::string> strings; // never erased from, growing a deque at the end keeps its elements where they are
+		size_t bytes = 0;
+	};
+
+	Shard sShards[STRING_POOL_SHARDS];
+
+	// FNV-1a
+	size_t getHash(const char* data, size_t length)
+	{
+		size_t hash = 2166136261u;
+		for(size_t i = 0; i < length; i++)
+		{
+			hash ^= (unsigned char)data[i];
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+	size_t getStringBytes(const std::string& value)
+	{
+		return sizeof(std::string) + ((value.size() > SMALL_STRING_SIZE) ? value.size() + 1 : 0);
+	}
+}
+
+const std::string* StringPool::intern(const std::string& value)
+{
+	return intern(value.data(), value.size());
+}
+
+const std::string* StringPool::intern(const char* value)
+{
+	return intern(value, strlen(value));
+}
+
+const std::string* StringPool::intern(const char* value, size_t length)
+{
+	const Key lookup = { value, length, getHash(value, length), nullptr };
+	Shard& shard = sShards[lookup.hash % STRING_POOL_SHARDS];
+
+	std::unique_lock<std::mutex> lock(shard.mutex);
+	auto it = shard.keys.find(lookup);
+	if(it != shard.keys.cend())
+		return it->string;
+
+	shard.strings.emplace_back(value, length);
+	const std::string* string = &shard.strings.back();
+	const Key key = { string->data(), length, lookup.hash, string };
+	shard.keys.insert(key);
+	shard.bytes += getStringBytes(*string) + sizeof(Key) + sizeof(void*); // plus the hash node
+
+	return string;
+}
+
+StringPool::Stats StringPool::getStats()
+{
+	Stats stats = { 0, 0, 0, 0 };
+
+	for(int i = 0; i < STRING_POOL_SHARDS; i++)
+	{
+		std::unique_lock<std::mutex> lock(sShards[i].mutex);
+		stats.strings += sShards[i].keys.size();
+		stats.pooledBytes += sShards[i].bytes + sShards[i].keys.bucket_count() * sizeof(void*);
+	}
+
+	return stats;
+}
+
+void StringPool::addReference(const std::string* value, Stats& stats)
+{
+	++stats.references;
+	stats.pooledBytes += sizeof(void*);
+	stats.copiedBytes += getStringBytes(*value);
+}
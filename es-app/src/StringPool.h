@@ -0,0 +1,31 @@
+#pragma once
+#ifndef ES_APP_STRING_POOL_H
+#define ES_APP_STRING_POOL_H
+
+#include <string>
+
+// Shares one copy of the metadata values that repeat across games (developers, genres, "unknown", ...).
+// Interned strings are never released, two interned pointers are equal exactly when their strings are.
+// Thread safe, games are loaded by several threads at once.
+class StringPool
+{
+public:
+	struct Stats
+	{
+		size_t strings;     // distinct values in the pool
+		size_t references;  // slots pointing into the pool, see addReference()
+		size_t pooledBytes; // memory used by the pool and the pointers referencing it
+		size_t copiedBytes; // memory the references would have used as separate std::string copies
+	};
+
+	// looking up a value that is already pooled doesn't allocate
+	static const std::string* intern(const std::string& value);
+	static const std::string* intern(const char* value);
+	static const std::string* intern(const char* value, size_t length);
+
+	// the pool only knows its strings, the references are counted by walking the slots that are alive
+	static Stats getStats();
+	static void addReference(const std::string* value, Stats& stats);
+};
+
+#endif // ES_APP_STRING_POOL_H
@@ -1,48 +1,63 @@
 #include "SystemData.h"
 
 #include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
 #include "CollectionSystemManager.h"
+#include "DirectoryScanCache.h"
 #include "FileFilterIndex.h"
 #include "FileSorts.h"
+#include "GameSearchIndex.h"
 #include "Gamelist.h"
+#include "GamelistSnapshot.h"
+#include "GamelistWriter.h"
 #include "Log.h"
+#include "MetaDataJournal.h"
 #include "platform.h"
 #include "Settings.h"
+#include "StringPool.h"
 #include "ThemeData.h"
 #include "views/UIModeController.h"
+#include "Window.h"
 #include <pugixml/src/pugixml.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
 #ifdef WIN32
 #include <Windows.h>
 #endif
 
+// how long quitting waits for the gamelists to be saved
+#define GAMELIST_FLUSH_TIMEOUT 10000
+
 std::vector<SystemData*> SystemData::sSystemVector;
+std::thread* SystemData::sBackgroundLoader = nullptr;
+std::atomic<bool> SystemData::sStopBackgroundLoading(false);
 
 SystemData::SystemData(const std::string& name, const std::string& fullName, SystemEnvironmentData* envData, const std::string& themeFolder, bool CollectionSystem) :
-	mName(name), mFullName(fullName), mEnvData(envData), mThemeFolder(themeFolder), mIsCollectionSystem(CollectionSystem), mIsGameSystem(true)
+	mName(name), mSortKey(StringPool::intern(Utils::String::toUpper(name))), mFullName(fullName), mEnvData(envData), mThemeFolder(themeFolder), mIsCollectionSystem(CollectionSystem), mIsGameSystem(true), mJournalPending(false), mCachedGameCount(0), mDisplayedGameCount(0), mGamesValid(false), mGamesGeneration(0), mMetaDataGeneration(0)
 {
 	mFilterIndex = new FileFilterIndex();
+	mDisplayedGameCountGeneration = mFilterIndex->getGeneration() - 1;
+	mArena = new FileDataArena();
+	mSearchIndex = CollectionSystem ? nullptr : new GameSearchIndex(this);
+
+	// collections are filled by CollectionSystemManager, there's nothing to load for them
+	mGameListLoaded = CollectionSystem;
 
-	// if it's an actual system, initialize it, if not, just create the data structure
+	// if it's an actual system, create its root folder, the games are loaded afterwards by loadConfig()
 	if(!CollectionSystem)
 	{
-		mRootFolder = new FileData(FOLDER, mEnvData->mStartPath, mEnvData, this);
-		mRootFolder->metadata.set("name", mFullName);
-
-		if(!Settings::getInstance()->getBool("ParseGamelistOnly"))
-			populateFolder(mRootFolder);
-
-		if(!Settings::getInstance()->getBool("IgnoreGamelist"))
-			parseGamelist(this);
-
-		mRootFolder->sort(FileSorts::SortTypes.at(0));
-
-		indexAllGameFilters(mRootFolder);
+		mRootFolder = new (mArena) FileData(FOLDER, mEnvData->mStartPath, mEnvData, this);
+		mRootFolder->metadata.set(META_NAME, mFullName);
 	}
 	else
 	{
 		// virtual systems are updated afterwards, we're just creating the data structure
-		mRootFolder = new FileData(FOLDER, "" + name, mEnvData, this);
+		mRootFolder = new (mArena) FileData(FOLDER, "" + name, mEnvData, this);
 	}
 	setIsGameSystemStatus();
 	loadTheme();
@@ -50,10 +65,9 @@ SystemData::SystemData(const std::string& name, const std::string& fullName, Sys
 
 SystemData::~SystemData()
 {
-	if(Settings::getInstance()->getString("SaveGamelistsMode") == "on exit")
-		writeMetaData();
-
-	delete mRootFolder;
+	// releases the whole tree at once, the games don't remove themselves from the index one by one
+	delete mSearchIndex;
+	delete mArena;
 	delete mFilterIndex;
 }
 
@@ -65,19 +79,298 @@ void SystemData::setIsGameSystemStatus()
 	mIsGameSystem = (mName != "retropie");
 }
 
-void SystemData::populateFolder(FileData* folder)
+void SystemData::loadGameList()
+{
+	// restore the whole tree in one go if neither the rom folders nor the gamelist changed since the last start
+	const bool useSnapshot = Settings::getInstance()->getBool("GamelistSnapshot");
+	if(!useSnapshot || !loadGamelistSnapshot(this))
+	{
+		std::vector<SnapshotFolder> folders;
+
+		if(!Settings::getInstance()->getBool("ParseGamelistOnly"))
+		{
+			if(Settings::getInstance()->getBool("DirectoryScanCache"))
+			{
+				// the scan result also depends on the extensions and hidden files setting, a cache written with other values is discarded
+				std::string signature = Settings::getInstance()->getBool("ShowHiddenFiles") ? "hidden" : "nohidden";
+				signature += mEnvData->mExtensionMatcher.ignoresCase() ? " nocase" : " case";
+				for(auto it = mEnvData->mSearchExtensions.cbegin(); it != mEnvData->mSearchExtensions.cend(); ++it)
+					signature += " " + *it;
+
+				DirectoryScanCache scanCache(getScanCachePath(), signature);
+				scanCache.load();
+				populateFolder(mRootFolder, &scanCache, folders);
+				scanCache.save();
+			}
+			else
+			{
+				populateFolder(mRootFolder, nullptr, folders);
+			}
+		}
+
+		const std::string gamelistPath = getGamelistPath(false);
+		const long long gamelistModified = Utils::FileSystem::getModifiedTime(gamelistPath);
+
+		if(!Settings::getInstance()->getBool("IgnoreGamelist"))
+			parseGamelist(this);
+
+		if(useSnapshot)
+			saveGamelistSnapshot(this, folders, gamelistPath, gamelistModified);
+	}
+
+	// statistics saved since the gamelist was last written, before the filters are indexed as favorites are among them
+	if(!Settings::getInstance()->getBool("IgnoreGamelist") && replayMetaDataJournal(this))
+		mJournalPending = true;
+
+	mRootFolder->sort(FileSorts::SortTypes.at(0));
+
+	indexAllGameFilters(mRootFolder);
+
+	// remember the game count for the carousel, so this system doesn't need to be loaded at startup next time
+	if(Settings::getInstance()->getBool("LazySystemLoading"))
+	{
+		unsigned int count = mRootFolder->getGameCount();
+		if(count != mCachedGameCount)
+		{
+			mCachedGameCount = count;
+			saveCachedGameCount();
+		}
+	}
+
+	// only flag it once the tree is complete, other threads start using it as soon as they see the flag
+	mGameListLoaded = true;
+}
+
+void SystemData::loadGameListIfNeeded()
+{
+	if(mGameListLoaded)
+		return;
+
+	// the background loader might be busy with this system, wait for it instead of loading twice
+	std::unique_lock<std::mutex> lock(mGameListMutex);
+	if(!mGameListLoaded)
+	{
+		LOG(LogInfo) << "Loading system \"" << mName << "\" on demand";
+		loadGameList();
+	}
+}
+
+void SystemData::loadAllGameLists()
+{
+	for(auto it = sSystemVector.cbegin(); it != sSystemVector.cend(); it++)
+		(*it)->loadGameListIfNeeded();
+}
+
+void SystemData::startBackgroundLoading()
+{
+	std::vector<SystemData*> systems;
+	for(auto it = sSystemVector.cbegin(); it != sSystemVector.cend(); it++)
+	{
+		if(!(*it)->isGameListLoaded())
+			systems.push_back(*it);
+	}
+
+	if(systems.empty())
+		return;
+
+	// the thread works on its own copy of the list, sSystemVector changes when collections are toggled
+	sStopBackgroundLoading = false;
+	sBackgroundLoader = new std::thread([systems]
+	{
+		for(auto it = systems.cbegin(); it != systems.cend() && !sStopBackgroundLoading; it++)
+			(*it)->loadGameListIfNeeded();
+	});
+}
+
+void SystemData::stopBackgroundLoading()
+{
+	if(!sBackgroundLoader)
+		return;
+
+	// the system being loaded is finished, the remaining ones are skipped
+	sStopBackgroundLoading = true;
+	sBackgroundLoader->join();
+	delete sBackgroundLoader;
+	sBackgroundLoader = nullptr;
+}
+
+bool SystemData::loadCachedGameCount()
+{
+	std::ifstream file(getGameCountCachePath());
+	unsigned int count = 0;
+
+	// no cache or no games, the system has to be loaded to find out if it should be shown at all
+	if(!(file >> count) || count == 0)
+		return false;
+
+	mCachedGameCount = count;
+	return true;
+}
+
+void SystemData::saveCachedGameCount()
+{
+	const std::string path = getGameCountCachePath();
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(path));
+
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	file << mCachedGameCount << "\n";
+}
+
+void SystemData::scanFolder(const std::string& folderPath, std::vector<DirectoryScanCache::Entry>& entries)
+{
+	bool showHidden = Settings::getInstance()->getBool("ShowHiddenFiles");
+	Utils::FileSystem::dirEntryList dirContent = Utils::FileSystem::getDirEntries(folderPath);
+	for(Utils::FileSystem::dirEntryList::const_iterator it = dirContent.cbegin(); it != dirContent.cend(); ++it)
+	{
+		// skip hidden files and folders
+		if(!showHidden && it->isHidden)
+			continue;
+
+		//we allow a list of extensions to be defined (delimited with a space), the matcher checks the file name against all of them at once
+
+		//fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
+		//see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
+
+		if(mEnvData->mExtensionMatcher.matches(it->name))
+			entries.push_back({ it->name, true });
+		else if(it->isDirectory)
+			entries.push_back({ it->name, false });
+	}
+}
+
+// a folder being populated, its subfolders are only attached once the whole tree has been scanned
+// so the scan of a subtree never touches FileData owned by another thread
+struct SystemData::FolderScanNode
+{
+	FolderScanNode(FileData* _folder, FolderScanNode* _parent) : folder(_folder), parent(_parent) { }
+
+	FileData* folder;
+	FolderScanNode* parent;
+	Utils::FileSystem::FileInfo info;
+	std::vector<std::unique_ptr<FolderScanNode>> subFolders;
+};
+
+void SystemData::populateFolder(FileData* folder, DirectoryScanCache* scanCache, std::vector<SnapshotFolder>& folders)
+{
+	FolderScanNode root(folder, nullptr);
+
+	int numThreads = 1;
+	if(Settings::getInstance()->getBool("ParallelFolderScan"))
+		numThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+	if(numThreads == 1)
+	{
+		std::vector<FolderScanNode*> stack(1, &root);
+		while(!stack.empty())
+		{
+			FolderScanNode* node = stack.back();
+			stack.pop_back();
+
+			populateFolderNode(node, scanCache);
+			for(auto it = node->subFolders.crbegin(); it != node->subFolders.crend(); ++it)
+				stack.push_back(it->get());
+		}
+	}
+	else
+	{
+		// every worker takes the newest folder from its own queue (depth first) and, once it runs dry,
+		// steals the oldest folder of another worker, which is usually the largest subtree left
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<FolderScanNode*> nodes;
+		};
+
+		std::vector<WorkQueue> queues(numThreads);
+		std::atomic<int> pending(1);
+		queues[0].nodes.push_back(&root);
+
+		auto worker = [&](int index)
+		{
+			while(pending > 0)
+			{
+				FolderScanNode* node = nullptr;
+
+				{
+					std::unique_lock<std::mutex> lock(queues[index].mutex);
+					if(!queues[index].nodes.empty())
+					{
+						node = queues[index].nodes.back();
+						queues[index].nodes.pop_back();
+					}
+				}
+
+				for(int i = 1; !node && (i < numThreads); ++i)
+				{
+					WorkQueue& victim = queues[(index + i) % numThreads];
+					std::unique_lock<std::mutex> lock(victim.mutex);
+					if(!victim.nodes.empty())
+					{
+						node = victim.nodes.front();
+						victim.nodes.pop_front();
+					}
+				}
+
+				if(!node)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					continue;
+				}
+
+				populateFolderNode(node, scanCache);
+
+				if(!node->subFolders.empty())
+				{
+					std::unique_lock<std::mutex> lock(queues[index].mutex);
+					for(auto it = node->subFolders.crbegin(); it != node->subFolders.crend(); ++it)
+						queues[index].nodes.push_back(it->get());
+					pending += (int)node->subFolders.size();
+				}
+
+				--pending;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for(int i = 1; i < numThreads; ++i)
+			threads.push_back(std::thread(worker, i));
+
+		worker(0);
+
+		for(auto it = threads.begin(); it != threads.end(); ++it)
+			it->join();
+	}
+
+	attachSubFolders(&root, folders);
+}
+
+void SystemData::populateFolderNode(FolderScanNode* node, DirectoryScanCache* scanCache)
 {
+	FileData* folder = node->folder;
 	const std::string& folderPath = folder->getPath();
-	if(!Utils::FileSystem::isDirectory(folderPath))
+
+	node->info = Utils::FileSystem::getFileInfo(folderPath);
+	if(!node->info.isDirectory)
 	{
 		LOG(LogWarning) << "Error - folder with path \"" << folderPath << "\" is not a directory!";
 		return;
 	}
 
-	//make sure that this isn't a symlink to a thing we already have
-	if(Utils::FileSystem::isSymlink(folderPath))
+	//make sure that this isn't a symlink to a folder we're already in, it would recurse forever
+	if(node->info.inode != 0)
 	{
-		//if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
+		for(FolderScanNode* parent = node->parent; parent != nullptr; parent = parent->parent)
+		{
+			if((parent->info.device == node->info.device) && (parent->info.inode == node->info.inode))
+			{
+				LOG(LogWarning) << "Skipping infinitely recursive symlink \"" << folderPath << "\"";
+				return;
+			}
+		}
+	}
+	else if(Utils::FileSystem::isSymlink(folderPath))
+	{
+		//no inodes on this platform, if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
 		if(folderPath.find(Utils::FileSystem::getCanonicalPath(folderPath)) == 0)
 		{
 			LOG(LogWarning) << "Skipping infinitely recursive symlink \"" << folderPath << "\"";
@@ -85,30 +378,31 @@ void SystemData::populateFolder(FileData* folder)
 		}
 	}
 
+	// only list the directory if it changed since the scan cache was written
+	std::vector<DirectoryScanCache::Entry> entries;
+	if(scanCache)
+	{
+		if(!scanCache->get(folderPath, node->info.modified, entries))
+		{
+			scanFolder(folderPath, entries);
+			scanCache->put(folderPath, node->info.modified, entries);
+		}
+	}
+	else
+	{
+		scanFolder(folderPath, entries);
+	}
+
 	std::string filePath;
-	std::string extension;
 	bool isGame;
-	bool showHidden = Settings::getInstance()->getBool("ShowHiddenFiles");
-	Utils::FileSystem::stringList dirContent = Utils::FileSystem::getDirContent(folderPath);
-	for(Utils::FileSystem::stringList::const_iterator it = dirContent.cbegin(); it != dirContent.cend(); ++it)
+	for(std::vector<DirectoryScanCache::Entry>::const_iterator it = entries.cbegin(); it != entries.cend(); ++it)
 	{
-		filePath = *it;
-
-		// skip hidden files and folders
-		if(!showHidden && Utils::FileSystem::isHidden(filePath))
-			continue;
-
-		//this is a little complicated because we allow a list of extensions to be defined (delimited with a space)
-		//we first get the extension of the file itself:
-		extension = Utils::FileSystem::getExtension(filePath);
-
-		//fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
-		//see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
+		filePath = Utils::FileSystem::getGenericPath(folderPath + "/" + it->name);
 
 		isGame = false;
-		if(std::find(mEnvData->mSearchExtensions.cbegin(), mEnvData->mSearchExtensions.cend(), extension) != mEnvData->mSearchExtensions.cend())
+		if(it->isGame)
 		{
-			FileData* newGame = new FileData(GAME, filePath, mEnvData, this);
+			FileData* newGame = new (mArena) FileData(GAME, filePath, mEnvData, this);
 
 			// preventing new arcade assets to be added
 			if(!newGame->isArcadeAsset())
@@ -118,19 +412,129 @@ void SystemData::populateFolder(FileData* folder)
 			}
 		}
 
-		//add directories that also do not match an extension as folders
-		if(!isGame && Utils::FileSystem::isDirectory(filePath))
-		{
-			FileData* newFolder = new FileData(FOLDER, filePath, mEnvData, this);
-			populateFolder(newFolder);
+		//add directories that also do not match an extension as folders, they're scanned and attached later
+		if(!isGame && (!it->isGame || Utils::FileSystem::isDirectory(filePath)))
+			node->subFolders.push_back(std::unique_ptr<FolderScanNode>(new FolderScanNode(new (mArena) FileData(FOLDER, filePath, mEnvData, this), node)));
+	}
+}
 
-			//ignore folders that do not contain games
-			if(newFolder->getChildrenByFilename().size() == 0)
-				delete newFolder;
-			else
-				folder->addChild(newFolder);
+void SystemData::attachSubFolders(FolderScanNode* node, std::vector<SnapshotFolder>& folders)
+{
+	folders.push_back({ node->folder->getPath(), node->info.modified });
+
+	for(auto it = node->subFolders.cbegin(); it != node->subFolders.cend(); ++it)
+	{
+		attachSubFolders(it->get(), folders);
+
+		//ignore folders that do not contain games
+		FileData* subFolder = (*it)->folder;
+		if(subFolder->getChildrenByFilename().size() == 0)
+			delete subFolder;
+		else
+			node->folder->addChild(subFolder);
+	}
+}
+
+FileData* SystemData::findFile(const std::string& path) const
+{
+	const std::string& startPath = getStartPath();
+	if(path == startPath)
+		return mRootFolder;
+
+	if((path.size() <= startPath.size() + 1) || (path.compare(0, startPath.size(), startPath) != 0) || (path[startPath.size()] != '/'))
+		return nullptr;
+
+	// children are keyed by file name, follow the path one segment at a time
+	FileData* file = mRootFolder;
+	std::string key;
+	size_t start = startPath.size() + 1;
+	while(start <= path.size())
+	{
+		size_t end = path.find('/', start);
+		if(end == std::string::npos)
+			end = path.size();
+
+		key.assign(path, start, end - start);
+		const FileData::ChildMap& children = file->getChildrenByFilename();
+		auto it = children.find(key);
+		if(it == children.cend())
+			return nullptr;
+
+		file = it->second;
+		start = end + 1;
+	}
+
+	return file;
+}
+
+FileData* SystemData::addFile(const std::string& path, std::vector<SnapshotFolder>& folders)
+{
+	const std::string& startPath = getStartPath();
+	if((path.size() <= startPath.size() + 1) || (path.compare(0, startPath.size(), startPath) != 0) || (path[startPath.size()] != '/') || findFile(path))
+		return nullptr;
+
+	if(!Settings::getInstance()->getBool("ShowHiddenFiles") && Utils::FileSystem::isHidden(path))
+		return nullptr;
+
+	// the closest folder that is already part of the tree, the ones in between only exist once they contain a game
+	std::vector<std::string> missingFolders;
+	std::string parentPath = Utils::FileSystem::getParent(path);
+	FileData* parent = findFile(parentPath);
+	while(!parent)
+	{
+		missingFolders.push_back(parentPath);
+		parentPath = Utils::FileSystem::getParent(parentPath);
+		parent = findFile(parentPath);
+	}
+
+	if(parent->getType() != FOLDER)
+		return nullptr;
+
+	FileData* file = nullptr;
+	if(mEnvData->mExtensionMatcher.matches(Utils::FileSystem::getFileName(path)))
+	{
+		FileData* newGame = new (mArena) FileData(GAME, path, mEnvData, this);
+
+		// preventing new arcade assets to be added
+		if(!newGame->isArcadeAsset())
+			file = newGame;
+	}
+
+	if(!file && Utils::FileSystem::isDirectory(path))
+	{
+		FileData* newFolder = new (mArena) FileData(FOLDER, path, mEnvData, this);
+		populateFolder(newFolder, nullptr, folders);
+
+		//ignore folders that do not contain games
+		if(newFolder->getChildrenByFilename().size() == 0)
+		{
+			delete newFolder;
+			return nullptr;
 		}
+
+		file = newFolder;
 	}
+
+	if(!file)
+		return nullptr;
+
+	if(file->getType() == GAME)
+		mFilterIndex->addToIndex(file);
+	else
+		indexAllGameFilters(file);
+
+	FileData* attached = file;
+	for(auto it = missingFolders.cbegin(); it != missingFolders.cend(); ++it)
+	{
+		FileData* folder = new (mArena) FileData(FOLDER, *it, mEnvData, this);
+		folder->addChild(attached);
+		attached = folder;
+	}
+
+	parent->addChild(attached);
+	parent->sort(FileSorts::SortTypes.at(0));
+
+	return attached;
 }
 
 void SystemData::indexAllGameFilters(const FileData* folder)
@@ -164,8 +568,18 @@ std::vector<std::string> readList(const std::string& str, const char* delims = "
 	return ret;
 }
 
+static void renderLoadingProgress(Window* window, const SystemData* system, int loaded, int total)
+{
+	if(!window || !Settings::getInstance()->getBool("SplashScreen") || !Settings::getInstance()->getBool("SplashScreenProgress"))
+		return;
+
+	char buffer[100];
+	snprintf(buffer, sizeof(buffer), "Loading system '%s' (%d/%d)", system->getFullName().c_str(), loaded, total);
+	window->renderLoadingScreen(std::string(buffer));
+}
+
 //creates systems from information located in a config file
-bool SystemData::loadConfig()
+bool SystemData::loadConfig(Window* window)
 {
 	deleteSystems();
 
@@ -199,6 +613,9 @@ bool SystemData::loadConfig()
 		return false;
 	}
 
+	// systems are created in config order, their games are loaded below
+	std::vector<SystemData*> systems;
+
 	for(pugi::xml_node system = systemList.child("system"); system; system = system.next_sibling("system"))
 	{
 		std::string name, fullname, path, cmd, themeFolder;
@@ -260,13 +677,84 @@ bool SystemData::loadConfig()
 		SystemEnvironmentData* envData = new SystemEnvironmentData;
 		envData->mStartPath = path;
 		envData->mSearchExtensions = extensions;
+		envData->mExtensionMatcher.setExtensions(extensions, Settings::getInstance()->getBool("IgnoreExtensionCase"));
+		envData->mLocalArt.setDirectory(path + "/images");
 		envData->mLaunchCommand = cmd;
 		envData->mPlatformIds = platformIds;
 
-		SystemData* newSys = new SystemData(name, fullname, envData, themeFolder);
-		if(newSys->getRootFolder()->getChildrenByFilename().size() == 0)
+		systems.push_back(new SystemData(name, fullname, envData, themeFolder));
+	}
+
+	// with LazySystemLoading, systems whose game count is cached are only loaded when needed, or in the background after startup
+	const bool lazyLoading = Settings::getInstance()->getBool("LazySystemLoading");
+	std::vector<SystemData*> toLoad;
+	for(auto it = systems.cbegin(); it != systems.cend(); it++)
+	{
+		if(!lazyLoading || !(*it)->loadCachedGameCount())
+			toLoad.push_back(*it);
+	}
+
+	const int total = (int)toLoad.size();
+	unsigned int numThreads = std::min((unsigned int)total, std::max(std::thread::hardware_concurrency(), 1u));
+
+	if(Settings::getInstance()->getBool("ParallelSystemLoading") && numThreads > 1)
+	{
+		// every system only touches its own data while loading, so let a pool of workers pick them
+		// up one by one while this thread reports each finished system on the splash screen
+		std::atomic<int> nextSystem(0);
+		std::mutex mutex;
+		std::condition_variable event;
+		std::vector<SystemData*> finished;
+		std::vector<std::thread> workers;
+
+		for(unsigned int i = 0; i < numThreads; i++)
+		{
+			workers.push_back(std::thread([&]
+			{
+				for(int index = nextSystem++; index < total; index = nextSystem++)
+				{
+					toLoad[index]->loadGameList();
+
+					std::unique_lock<std::mutex> lock(mutex);
+					finished.push_back(toLoad[index]);
+					event.notify_one();
+				}
+			}));
+		}
+
+		int loaded = 0;
+		while(loaded < total)
+		{
+			std::vector<SystemData*> done;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				event.wait(lock, [&finished] { return !finished.empty(); });
+				done.swap(finished);
+			}
+
+			for(auto it = done.cbegin(); it != done.cend(); it++)
+				renderLoadingProgress(window, *it, ++loaded, total);
+		}
+
+		for(auto it = workers.begin(); it != workers.end(); it++)
+			it->join();
+	}
+	else
+	{
+		for(int i = 0; i < total; i++)
 		{
-			LOG(LogWarning) << "System \"" << name << "\" has no games! Ignoring it.";
+			renderLoadingProgress(window, toLoad[i], i + 1, total);
+			toLoad[i]->loadGameList();
+		}
+	}
+
+	// keep the config order, no matter in which order the systems finished loading
+	for(auto it = systems.cbegin(); it != systems.cend(); it++)
+	{
+		SystemData* newSys = *it;
+		if(newSys->isGameListLoaded() && newSys->getRootFolder()->getChildrenByFilename().size() == 0)
+		{
+			LOG(LogWarning) << "System \"" << newSys->getName() << "\" has no games! Ignoring it.";
 			delete newSys;
 		}else{
 			sSystemVector.push_back(newSys);
@@ -274,6 +762,19 @@ bool SystemData::loadConfig()
 	}
 	CollectionSystemManager::get()->loadCollectionSystems();
 
+	// counted in the trees as they are now, with LazySystemLoading only the systems loaded so far
+	StringPool::Stats stats = StringPool::getStats();
+	for(auto it = sSystemVector.cbegin(); it != sSystemVector.cend(); it++)
+	{
+		if(!(*it)->isCollection() && (*it)->isGameListLoaded())
+			(*it)->getRootFolder()->visitFilesRecursive(GAME | FOLDER, false, [&stats](FileData* file) -> bool { file->metadata.addPooledReferences(stats); return true; });
+	}
+	LOG(LogInfo) << "Metadata values: " << stats.references << " shared through " << stats.strings << " pooled strings, "
+		<< (stats.pooledBytes / 1024) << " KB instead of " << (stats.copiedBytes / 1024) << " KB as separate copies";
+
+	if(lazyLoading)
+		startBackgroundLoading();
+
 	return true;
 }
 
@@ -325,6 +826,17 @@ void SystemData::writeExampleConfig(const std::string& path)
 
 void SystemData::deleteSystems()
 {
+	stopBackgroundLoading();
+
+	// queue the gamelists of all systems first, they're then written in parallel instead of one after the other
+	for(auto it = sSystemVector.cbegin(); it != sSystemVector.cend(); ++it)
+	{
+		SystemData* system = *it;
+		if(system->mGameListLoaded && ((Settings::getInstance()->getString("SaveGamelistsMode") == "on exit") || system->mJournalPending))
+			system->writeMetaData();
+	}
+	GamelistWriter::getInstance()->flush(GAMELIST_FLUSH_TIMEOUT);
+
 	for(unsigned int i = 0; i < sSystemVector.size(); i++)
 	{
 		delete sSystemVector.at(i);
@@ -393,6 +905,26 @@ std::string SystemData::getGamelistPath(bool forWrite) const
 	return "/etc/emulationstation/gamelists/" + mName + "/gamelist.xml";
 }
 
+std::string SystemData::getScanCachePath() const
+{
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/cache/" + mName + "/dirscan.cache";
+}
+
+std::string SystemData::getSnapshotPath() const
+{
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/cache/" + mName + "/gamelist.snapshot";
+}
+
+std::string SystemData::getJournalPath() const
+{
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/gamelists/" + mName + "/gamelist.journal";
+}
+
+std::string SystemData::getGameCountCachePath() const
+{
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/cache/" + mName + "/gamecount";
+}
+
 std::string SystemData::getThemePath() const
 {
 	// where we check for themes, in order:
@@ -424,7 +956,10 @@ bool SystemData::hasGamelist() const
 
 unsigned int SystemData::getGameCount() const
 {
-	return (unsigned int)mRootFolder->getFilesRecursive(GAME).size();
+	if(!mGameListLoaded)
+		return mCachedGameCount;
+
+	return mRootFolder->getGameCount();
 }
 
 SystemData* SystemData::getRandomSystem()
@@ -460,19 +995,53 @@ SystemData* SystemData::getRandomSystem()
 
 FileData* SystemData::getRandomGame()
 {
-	std::vector<FileData*> list = mRootFolder->getFilesRecursive(GAME, true);
-	unsigned int total = (int)list.size();
+	loadGameListIfNeeded();
+
+	unsigned int total = getDisplayedGameCount();
 	int target = 0;
 	// get random number in range
 	if (total == 0)
 		return NULL;
 	target = (int)Math::round((std::rand() / (float)RAND_MAX) * (total - 1));
-	return list.at(target);
+
+	FileData* game = NULL;
+	mRootFolder->visitFilesRecursive(GAME, true, [&](FileData* file) -> bool { game = file; return (target-- > 0); });
+	return game;
 }
 
 unsigned int SystemData::getDisplayedGameCount() const
 {
-	return (unsigned int)mRootFolder->getFilesRecursive(GAME, true).size();
+	if(!mGameListLoaded)
+		return mCachedGameCount;
+
+	if(!mFilterIndex->isFiltered())
+		return mRootFolder->getGameCount();
+
+	// with filters the games are only counted again once the filters or the indexed games changed
+	if(mDisplayedGameCountGeneration != mFilterIndex->getGeneration())
+	{
+		mDisplayedGameCount = 0;
+		mRootFolder->visitFilesRecursive(GAME, true, [this](FileData* /*game*/) -> bool { ++mDisplayedGameCount; return true; });
+		mDisplayedGameCountGeneration = mFilterIndex->getGeneration();
+	}
+
+	return mDisplayedGameCount;
+}
+
+const std::vector<FileData*>& SystemData::getGames()
+{
+	std::unique_lock<std::mutex> lock(mGamesMutex);
+
+	if(!mGamesValid)
+	{
+		// set first, a change while the list is built invalidates it again
+		mGamesValid = true;
+		mGames.clear();
+		mGames.reserve(mRootFolder->getGameCount());
+		mRootFolder->visitFilesRecursive(GAME, false, [this](FileData* game) -> bool { mGames.push_back(game); return true; });
+	}
+
+	return mGames;
 }
 
 void SystemData::loadTheme()
@@ -504,8 +1073,9 @@ void SystemData::writeMetaData() {
 	if(Settings::getInstance()->getBool("IgnoreGamelist") || mIsCollectionSystem)
 		return;
 
-	//save changed game data back to xml
-	updateGamelist(this);
+	//save changed game data back to xml, the journal is removed once that's done
+	GamelistWriter::getInstance()->save(this);
+	mJournalPending = false;
 }
 
 void SystemData::onMetaDataSavePoint() {
@@ -514,3 +1084,15 @@ void SystemData::onMetaDataSavePoint() {
 
 	writeMetaData();
 }
+
+void SystemData::onStatisticsSavePoint(FileData* file) {
+	// a launch or a favorite toggle only appends to the journal, the gamelist is rewritten once on exit
+	if(Settings::getInstance()->getBool("MetaDataJournal") && !Settings::getInstance()->getBool("IgnoreGamelist") && !mIsCollectionSystem
+		&& (Settings::getInstance()->getString("SaveGamelistsMode") != "never") && appendMetaDataJournal(this, file))
+	{
+		mJournalPending = true;
+		return;
+	}
+
+	onMetaDataSavePoint();
+}
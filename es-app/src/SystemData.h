@@ -2,20 +2,32 @@
 #ifndef ES_APP_SYSTEM_DATA_H
 #define ES_APP_SYSTEM_DATA_H
 
+#include "DirectoryScanCache.h"
+#include "ExtensionMatcher.h"
+#include "GamelistSnapshot.h"
+#include "LocalArtIndex.h"
 #include "PlatformId.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 class FileData;
+class FileDataArena;
 class FileFilterIndex;
+class GameSearchIndex;
 class ThemeData;
+class Window;
 
 struct SystemEnvironmentData
 {
 	std::string mStartPath;
 	std::vector<std::string> mSearchExtensions;
+	ExtensionMatcher mExtensionMatcher; // built from mSearchExtensions when the config is loaded
+	LocalArtIndex mLocalArt; // <mStartPath>/images
 	std::string mLaunchCommand;
 	std::vector<PlatformIds::PlatformId> mPlatformIds;
 };
@@ -28,6 +40,7 @@ public:
 
 	inline FileData* getRootFolder() const { return mRootFolder; };
 	inline const std::string& getName() const { return mName; }
+	inline const std::string& getSortKey() const { return *mSortKey; } // upper-cased name, the games point at it, see FileData::getSystemSortKey
 	inline const std::string& getFullName() const { return mFullName; }
 	inline const std::string& getStartPath() const { return mEnvData->mStartPath; }
 	inline const std::vector<std::string>& getExtensions() const { return mEnvData->mSearchExtensions; }
@@ -40,13 +53,32 @@ public:
 
 	std::string getGamelistPath(bool forWrite) const;
 	bool hasGamelist() const;
+	std::string getScanCachePath() const; // ~/.emulationstation/cache/<system>/dirscan.cache
+	std::string getSnapshotPath() const; // ~/.emulationstation/cache/<system>/gamelist.snapshot
+	std::string getJournalPath() const; // ~/.emulationstation/gamelists/<system>/gamelist.journal
+	std::string getGameCountCachePath() const; // ~/.emulationstation/cache/<system>/gamecount
 	std::string getThemePath() const;
 
-	unsigned int getGameCount() const;
-	unsigned int getDisplayedGameCount() const;
+	unsigned int getGameCount() const; // the cached count until the games are loaded
+	unsigned int getDisplayedGameCount() const; // constant time unless the filters or the filtered games changed since the last call
+	const std::vector<FileData*>& getGames(); // all games in tree order, built once and kept until the tree changes
+	inline void invalidateGames() { if(mGamesValid.load(std::memory_order_relaxed)) { mGamesValid = false; ++mGamesGeneration; } }
+	inline unsigned int getGamesGeneration() const { return mGamesGeneration; } // changes whenever games are added or removed after getGames()
+	inline void invalidateMetaData() { ++mMetaDataGeneration; } // games were edited or scraped, the play statistics don't count
+	inline unsigned int getMetaDataGeneration() const { return mMetaDataGeneration; }
+
+	// with LazySystemLoading the games of a system are only loaded when first needed, or by a background thread after startup
+	inline bool isGameListLoaded() const { return mGameListLoaded; }
+	void loadGameListIfNeeded();
+	static void loadAllGameLists(); // for features that need every game, like auto collections, the scraper or the screensaver
+
+	// incremental updates of a loaded game tree, used by the RomFolderWatcher
+	FileData* findFile(const std::string& path) const; // the game or folder node of path, nullptr if it isn't part of the tree
+	FileData* addFile(const std::string& path, std::vector<SnapshotFolder>& folders); // adds the game or folder at path and indexes its games, returns the node that got attached to the existing tree or nullptr; folders receives every directory that was scanned
 
 	static void deleteSystems();
-	static bool loadConfig(); //Load the system config file at getConfigPath(). Returns true if no errors were encountered. An example will be written if the file doesn't exist.
+	static void stopBackgroundLoading(); // lets the lazy loader finish the system it's loading, skips the others
+	static bool loadConfig(Window* window = nullptr); //Load the system config file at getConfigPath(). Returns true if no errors were encountered. An example will be written if the file doesn't exist. If window is set, loading progress is shown on the splash screen.
 	static void writeExampleConfig(const std::string& path);
 	static std::string getConfigPath(bool forWrite); // if forWrite, will only return ~/.emulationstation/es_systems.cfg, never /etc/emulationstation/es_systems.cfg
 
@@ -68,25 +100,57 @@ public:
 	void loadTheme();
 
 	FileFilterIndex* getIndex() { return mFilterIndex; };
+	inline FileDataArena* getArena() const { return mArena; } // holds the FileData of this system
+	inline GameSearchIndex* getSearchIndex() const { return mSearchIndex; } // nullptr for collections, their games are found through their own systems
+
 	void onMetaDataSavePoint();
+	void onStatisticsSavePoint(FileData* file); // only the play statistics or the favorite flag of file changed
 
 private:
 	bool mIsCollectionSystem;
 	bool mIsGameSystem;
 	std::string mName;
+	const std::string* mSortKey; // interned, collection entries keep pointing at it
 	std::string mFullName;
 	SystemEnvironmentData* mEnvData;
 	std::string mThemeFolder;
 	std::shared_ptr<ThemeData> mTheme;
 
-	void populateFolder(FileData* folder);
+	void loadGameList(); // scan the rom folder and parse the gamelist, only touches this system so it can run on a worker thread
+	bool loadCachedGameCount();
+	void saveCachedGameCount();
+	static void startBackgroundLoading();
+	struct FolderScanNode;
+
+	void populateFolder(FileData* folder, DirectoryScanCache* scanCache, std::vector<SnapshotFolder>& folders); // build the tree below folder, on all cores if ParallelFolderScan is set
+	void populateFolderNode(FolderScanNode* node, DirectoryScanCache* scanCache); // add the games of a single folder and queue its subfolders
+	void attachSubFolders(FolderScanNode* node, std::vector<SnapshotFolder>& folders); // attach the subfolders that contain games once the scan is done, delete the others
+	void scanFolder(const std::string& folderPath, std::vector<DirectoryScanCache::Entry>& entries); // list the games and subfolders of a single directory
 	void indexAllGameFilters(const FileData* folder);
 	void setIsGameSystemStatus();
 	void writeMetaData();
 
 	FileFilterIndex* mFilterIndex;
+	FileDataArena* mArena;
+	GameSearchIndex* mSearchIndex;
 
 	FileData* mRootFolder;
+
+	std::atomic<bool> mGameListLoaded;
+	bool mJournalPending; // the metadata journal holds changes that aren't in the gamelist yet
+	std::mutex mGameListMutex;
+	unsigned int mCachedGameCount;
+	mutable unsigned int mDisplayedGameCount; // while filtered, as of mDisplayedGameCountGeneration of the filter index
+	mutable unsigned int mDisplayedGameCountGeneration;
+
+	std::vector<FileData*> mGames;
+	std::atomic<bool> mGamesValid;
+	std::atomic<unsigned int> mGamesGeneration;
+	std::atomic<unsigned int> mMetaDataGeneration;
+	std::mutex mGamesMutex;
+
+	static std::thread* sBackgroundLoader;
+	static std::atomic<bool> sStopBackgroundLoading;
 };
 
 #endif // ES_APP_SYSTEM_DATA_H
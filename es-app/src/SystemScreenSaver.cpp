@@ -257,6 +257,7 @@ unsigned long SystemScreenSaver::countGameListNodes(const char *nodeName)
 {
 	unsigned long nodeCount = 0;
 	std::vector<SystemData*>::const_iterator it;
+	SystemData::loadAllGameLists();
 	for (it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); ++it)
 	{
 		// We only want nodes from game systems that are not collections
@@ -265,17 +266,14 @@ unsigned long SystemScreenSaver::countGameListNodes(const char *nodeName)
 
 		FileData* rootFileData = (*it)->getRootFolder();
 
-		FileType type = GAME;
-		std::vector<FileData*> allFiles = rootFileData->getFilesRecursive(type, true);
-		std::vector<FileData*>::const_iterator itf;  // declare an iterator to a vector of strings
-
-		for(itf=allFiles.cbegin() ; itf < allFiles.cend(); itf++) {
-			if ((strcmp(nodeName, "video") == 0 && (*itf)->getVideoPath() != "") ||
-				(strcmp(nodeName, "image") == 0 && (*itf)->getImagePath() != ""))
+		rootFileData->visitFilesRecursive(GAME, true, [&](FileData* game) -> bool {
+			if ((strcmp(nodeName, "video") == 0 && game->getVideoPath() != "") ||
+				(strcmp(nodeName, "image") == 0 && game->getImagePath() != ""))
 			{
 				nodeCount++;
 			}
-		}
+			return true;
+		});
 	}
 	return nodeCount;
 }
@@ -309,34 +307,35 @@ void SystemScreenSaver::pickGameListNode(unsigned long index, const char *nodeNa
 
 		FileData* rootFileData = (*it)->getRootFolder();
 
-		FileType type = GAME;
-		std::vector<FileData*> allFiles = rootFileData->getFilesRecursive(type, true);
-		std::vector<FileData*>::const_iterator itf;  // declare an iterator to a vector of strings
-
-		for(itf=allFiles.cbegin() ; itf < allFiles.cend(); itf++) {
-			if ((strcmp(nodeName, "video") == 0 && (*itf)->getVideoPath() != "") ||
-				(strcmp(nodeName, "image") == 0 && (*itf)->getImagePath() != ""))
+		// stops at the game we're looking for
+		bool found = !rootFileData->visitFilesRecursive(GAME, true, [&](FileData* game) -> bool {
+			if ((strcmp(nodeName, "video") == 0 && game->getVideoPath() != "") ||
+				(strcmp(nodeName, "image") == 0 && game->getImagePath() != ""))
 			{
 				if (index-- == 0)
 				{
 					// We have it
 					path = "";
 					if (strcmp(nodeName, "video") == 0)
-						path = (*itf)->getVideoPath();
+						path = game->getVideoPath();
 					else if (strcmp(nodeName, "image") == 0)
-						path = (*itf)->getImagePath();
+						path = game->getImagePath();
 					mSystemName = (*it)->getFullName();
-					mGameName = (*itf)->getName();
-					mCurrentGame = (*itf);
+					mGameName = game->getName();
+					mCurrentGame = game;
 
 					// end of getting FileData
 					if (Settings::getInstance()->getString("ScreenSaverGameInfo") != "never")
 						writeSubtitle(mGameName.c_str(), mSystemName.c_str(),
 							(Settings::getInstance()->getString("ScreenSaverGameInfo") == "always"));
-					return;
+					return false;
 				}
 			}
-		}
+			return true;
+		});
+
+		if (found)
+			return;
 	}
 }
 
@@ -371,18 +370,18 @@ void SystemScreenSaver::pickRandomCustomImage(std::string& path)
 	{
 		std::string                   imageFilter = Settings::getInstance()->getString("SlideshowScreenSaverImageFilter");
 		std::vector<std::string>      matchingFiles;
-		Utils::FileSystem::stringList dirContent  = Utils::FileSystem::getDirContent(imageDir, Settings::getInstance()->getBool("SlideshowScreenSaverRecurse"));
+		Utils::FileSystem::dirEntryList dirContent = Utils::FileSystem::getDirEntries(imageDir, Settings::getInstance()->getBool("SlideshowScreenSaverRecurse"));
 
-		for(Utils::FileSystem::stringList::const_iterator it = dirContent.cbegin(); it != dirContent.cend(); ++it)
+		for(Utils::FileSystem::dirEntryList::const_iterator it = dirContent.cbegin(); it != dirContent.cend(); ++it)
 		{
-			if (Utils::FileSystem::isRegularFile(*it))
+			if (it->isRegularFile)
 			{
 				// If the image filter is empty, or the file extension is in the filter string,
 				//  add it to the matching files list
 				if ((imageFilter.length() <= 0) ||
-					(imageFilter.find(Utils::FileSystem::getExtension(*it)) != std::string::npos))
+					(imageFilter.find(Utils::FileSystem::getExtension(it->name)) != std::string::npos))
 				{
-					matchingFiles.push_back(*it);
+					matchingFiles.push_back(Utils::FileSystem::getGenericPath(imageDir + "/" + it->name));
 				}
 			}
 		}
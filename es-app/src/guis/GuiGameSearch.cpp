@@ -0,0 +1,160 @@
+#include "guis/GuiGameSearch.h"
+
+#include "components/ComponentList.h"
+#include "components/TextComponent.h"
+#include "components/TextEditComponent.h"
+#include "utils/StringUtil.h"
+#include "views/gamelist/IGameListView.h"
+#include "views/ViewController.h"
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "GameSearchIndex.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include "Window.h"
+#include <algorithm>
+
+// more results don't fit a screen anyway, a longer query narrows them down
+#define MAX_SEARCH_RESULTS 50
+
+// while the index is built, the results are searched again this often (ms)
+#define INCOMPLETE_REFRESH_INTERVAL 500
+
+// ms per frame spent on the index while it isn't built in the background
+#define SEARCH_INDEX_FRAME_BUDGET 4
+
+GuiGameSearch::GuiGameSearch(Window* window, SystemData* system) : GuiComponent(window),
+	mBackground(window, ":/frame.png"), mGrid(window, Vector2i(1, 4)), mSystem(system), mComplete(true), mRefreshTimer(0), mSelectedGame(nullptr)
+{
+	addChild(&mBackground);
+	addChild(&mGrid);
+
+	const std::string title = system ? "SEARCH " + Utils::String::toUpper(system->getFullName()) : "SEARCH GAMES";
+	mTitle = std::make_shared<TextComponent>(mWindow, title, Font::get(FONT_SIZE_LARGE), 0x555555FF, ALIGN_CENTER);
+
+	mText = std::make_shared<TextEditComponent>(mWindow);
+	mText->setSize(0, mText->getFont()->getHeight());
+
+	mHint = std::make_shared<TextComponent>(mWindow, "", Font::get(FONT_SIZE_SMALL), 0x999999FF, ALIGN_CENTER);
+
+	mList = std::make_shared<ComponentList>(mWindow);
+
+	mGrid.setEntry(mTitle, Vector2i(0, 0), false, true);
+	mGrid.setEntry(mText, Vector2i(0, 1), true, false, Vector2i(1, 1), GridFlags::BORDER_TOP | GridFlags::BORDER_BOTTOM);
+	mGrid.setEntry(mHint, Vector2i(0, 2), false, true);
+	mGrid.setEntry(mList, Vector2i(0, 3), true, true);
+
+	setSize(Renderer::getScreenWidth() * 0.6f, Renderer::getScreenHeight() * 0.8f);
+	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
+}
+
+void GuiGameSearch::onSizeChanged()
+{
+	mBackground.fitTo(mSize, Vector3f::Zero(), Vector2f(-32, -32));
+
+	mText->setSize(mSize.x() - 40, mText->getSize().y());
+
+	mGrid.setRowHeightPerc(0, mTitle->getFont()->getHeight() / mSize.y());
+	mGrid.setRowHeightPerc(1, (mText->getSize().y() + 20) / mSize.y());
+	mGrid.setRowHeightPerc(2, mHint->getFont()->getHeight() / mSize.y());
+	mGrid.setSize(mSize);
+}
+
+void GuiGameSearch::populateResults()
+{
+	// answered from the index as it stands, a query never waits for it to be built
+	std::vector<FileData*> games;
+	if(mSystem)
+		mComplete = mSystem->getSearchIndex()->search(mQuery, games);
+	else
+		mComplete = GameSearchIndex::searchAll(mQuery, games);
+
+	mHint->setText(mComplete ? "" : "STILL INDEXING, MORE GAMES MAY APPEAR");
+	mRefreshTimer = INCOMPLETE_REFRESH_INTERVAL;
+
+	// the games the gamelists don't show right now aren't found either
+	games.erase(std::remove_if(games.begin(), games.end(), [](FileData* game) { return !game->getSystem()->getIndex()->showFile(game); }), games.end());
+
+	// only the results that are shown get sorted
+	const size_t count = std::min(games.size(), (size_t)MAX_SEARCH_RESULTS);
+	std::partial_sort(games.begin(), games.begin() + count, games.end(), [](FileData* a, FileData* b) {
+		return a->metadata.getSortKey(META_NAME) < b->metadata.getSortKey(META_NAME);
+	});
+
+	mList->clear();
+
+	ComponentListRow row;
+	for(size_t i = 0; i < count; ++i)
+	{
+		FileData* game = games[i];
+
+		row.elements.clear();
+		row.addElement(std::make_shared<TextComponent>(mWindow, Utils::String::toUpper(game->getName()), Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
+		if(!mSystem)
+			row.addElement(std::make_shared<TextComponent>(mWindow, Utils::String::toUpper(game->getSystem()->getName()), Font::get(FONT_SIZE_SMALL), 0x999999FF, ALIGN_RIGHT), false);
+		row.makeAcceptInputHandler([this, game] { mSelectedGame = game; });
+		mList->addRow(row);
+	}
+
+	updateHelpPrompts();
+}
+
+bool GuiGameSearch::input(InputConfig* config, Input input)
+{
+	if(GuiComponent::input(config, input))
+		return true;
+
+	// pressing back when not text editing closes us
+	if(config->isMappedTo("b", input) && input.value)
+	{
+		delete this;
+		return true;
+	}
+
+	return false;
+}
+
+void GuiGameSearch::update(int deltaTime)
+{
+	GuiComponent::update(deltaTime);
+
+	// without background indexing the index is built while the search is open
+	if(!mComplete && !Settings::getInstance()->getBool("SearchIndexInBackground"))
+	{
+		if(mSystem)
+			mSystem->getSearchIndex()->update(SEARCH_INDEX_FRAME_BUDGET);
+		else
+			GameSearchIndex::updateAll(SEARCH_INDEX_FRAME_BUDGET);
+	}
+
+	// searched again whenever the text changed, the results follow the typing, and now and then while the index grows
+	if(!mComplete)
+		mRefreshTimer -= deltaTime;
+
+	if((mText->getValue() != mQuery) || (!mComplete && (mRefreshTimer <= 0)))
+	{
+		mQuery = mText->getValue();
+		populateResults();
+	}
+
+	// the game is shown from here rather than from the row, closing the menus deletes the list it was selected in
+	if(mSelectedGame)
+	{
+		FileData* game = mSelectedGame;
+		SystemData* system = game->getSystem();
+		Window* window = mWindow;
+
+		while(window->peekGui() != ViewController::get())
+			delete window->peekGui();
+
+		ViewController::get()->goToGameList(system);
+		ViewController::get()->getGameListView(system)->setCursor(game);
+	}
+}
+
+std::vector<HelpPrompt> GuiGameSearch::getHelpPrompts()
+{
+	std::vector<HelpPrompt> prompts = mGrid.getHelpPrompts();
+	prompts.push_back(HelpPrompt("b", "back"));
+	return prompts;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef ES_APP_GUIS_GUI_GAME_SEARCH_H
+#define ES_APP_GUIS_GUI_GAME_SEARCH_H
+
+#include "components/ComponentGrid.h"
+#include "components/NinePatchComponent.h"
+#include "GuiComponent.h"
+
+class ComponentList;
+class FileData;
+class SystemData;
+class TextComponent;
+class TextEditComponent;
+
+// Lists the games matching the text entered so far, see GameSearchIndex. Searches every system without one.
+// The results come from the index as it stands, while it's still being built they're refreshed as it grows.
+class GuiGameSearch : public GuiComponent
+{
+public:
+	GuiGameSearch(Window* window, SystemData* system);
+
+	bool input(InputConfig* config, Input input) override;
+	void update(int deltaTime) override;
+	void onSizeChanged() override;
+	std::vector<HelpPrompt> getHelpPrompts() override;
+
+private:
+	void populateResults();
+
+	NinePatchComponent mBackground;
+	ComponentGrid mGrid;
+
+	std::shared_ptr<TextComponent> mTitle;
+	std::shared_ptr<TextEditComponent> mText;
+	std::shared_ptr<TextComponent> mHint;
+	std::shared_ptr<ComponentList> mList;
+
+	SystemData* mSystem;
+	std::string mQuery; // the one the results were found for
+	bool mComplete; // the results were found in an up to date index
+	int mRefreshTimer; // ms until the results of an incomplete index are searched again
+	FileData* mSelectedGame; // shown once update() is done, the gui goes away with it
+};
+
+#endif // ES_APP_GUIS_GUI_GAME_SEARCH_H
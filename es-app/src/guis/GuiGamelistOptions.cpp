@@ -1,5 +1,6 @@
 #include "GuiGamelistOptions.h"
 
+#include "guis/GuiGameSearch.h"
 #include "guis/GuiGamelistFilter.h"
 #include "scrapers/Scraper.h"
 #include "views/gamelist/IGameListView.h"
@@ -86,6 +87,12 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) : Gui
 		mMenu.addRow(row);
 	}
 
+	row.elements.clear();
+	row.addElement(std::make_shared<TextComponent>(mWindow, "SEARCH GAMES", Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
+	row.addElement(makeArrow(mWindow), false);
+	row.makeAcceptInputHandler(std::bind(&GuiGamelistOptions::openGameSearch, this));
+	mMenu.addRow(row);
+
 	std::map<std::string, CollectionSystemData> customCollections = CollectionSystemManager::get()->getCustomCollectionSystems();
 
 	if(UIModeController::getInstance()->isUIModeFull() &&
@@ -146,6 +153,13 @@ void GuiGamelistOptions::openGamelistFilter()
 	mWindow->pushGui(ggf);
 }
 
+void GuiGamelistOptions::openGameSearch()
+{
+	// collections search every system, the games they hold are found there
+	SystemData* system = mSystem->isCollection() ? nullptr : mSystem;
+	mWindow->pushGui(new GuiGameSearch(mWindow, system));
+}
+
 void GuiGamelistOptions::startEditMode()
 {
 	std::string editingSystem = mSystem->getName();
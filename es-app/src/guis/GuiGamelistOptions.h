@@ -22,6 +22,7 @@ public:
 
 private:
 	void openGamelistFilter();
+	void openGameSearch();
 	void openMetaDataEd();
 	void startEditMode();
 	void exitEditMode();
@@ -5,6 +5,7 @@
 #include "components/SwitchComponent.h"
 #include "guis/GuiCollectionSystemsOptions.h"
 #include "guis/GuiDetectDevice.h"
+#include "guis/GuiGameSearch.h"
 #include "guis/GuiGeneralScreensaverOptions.h"
 #include "guis/GuiMsgBox.h"
 #include "guis/GuiScraperStart.h"
@@ -27,6 +28,8 @@ GuiMenu::GuiMenu(Window* window) : GuiComponent(window), mMenu(window, "MAIN MEN
 	if (isFullUI)
 		addEntry("SCRAPER", 0x777777FF, true, [this] { openScraperSettings(); });
 
+	addEntry("SEARCH GAMES", 0x777777FF, true, [this] { mWindow->pushGui(new GuiGameSearch(mWindow, nullptr)); });
+
 	addEntry("SOUND SETTINGS", 0x777777FF, true, [this] { openSoundSettings(); });
 
 
@@ -417,11 +420,66 @@ void GuiMenu::openOtherSettings()
 		Settings::getInstance()->setString("SaveGamelistsMode", gamelistsSaveMode->getSelected());
 	});
 
+	auto metadata_journal = std::make_shared<SwitchComponent>(mWindow);
+	metadata_journal->setState(Settings::getInstance()->getBool("MetaDataJournal"));
+	s->addWithLabel("JOURNAL PLAY STATISTICS", metadata_journal);
+	s->addSaveFunc([metadata_journal] { Settings::getInstance()->setBool("MetaDataJournal", metadata_journal->getState()); });
+
+	auto background_save = std::make_shared<SwitchComponent>(mWindow);
+	background_save->setState(Settings::getInstance()->getBool("SaveGamelistsInBackground"));
+	s->addWithLabel("SAVE GAMELISTS IN BACKGROUND", background_save);
+	s->addSaveFunc([background_save] { Settings::getInstance()->setBool("SaveGamelistsInBackground", background_save->getState()); });
+
+	auto background_search_index = std::make_shared<SwitchComponent>(mWindow);
+	background_search_index->setState(Settings::getInstance()->getBool("SearchIndexInBackground"));
+	s->addWithLabel("BUILD SEARCH INDEX IN BACKGROUND", background_search_index);
+	s->addSaveFunc([background_search_index] { Settings::getInstance()->setBool("SearchIndexInBackground", background_search_index->getState()); });
+
 	auto parse_gamelists = std::make_shared<SwitchComponent>(mWindow);
 	parse_gamelists->setState(Settings::getInstance()->getBool("ParseGamelistOnly"));
 	s->addWithLabel("PARSE GAMESLISTS ONLY", parse_gamelists);
 	s->addSaveFunc([parse_gamelists] { Settings::getInstance()->setBool("ParseGamelistOnly", parse_gamelists->getState()); });
 
+	auto parallel_loading = std::make_shared<SwitchComponent>(mWindow);
+	parallel_loading->setState(Settings::getInstance()->getBool("ParallelSystemLoading"));
+	s->addWithLabel("LOAD SYSTEMS IN PARALLEL", parallel_loading);
+	s->addSaveFunc([parallel_loading] { Settings::getInstance()->setBool("ParallelSystemLoading", parallel_loading->getState()); });
+
+	auto scan_cache = std::make_shared<SwitchComponent>(mWindow);
+	scan_cache->setState(Settings::getInstance()->getBool("DirectoryScanCache"));
+	s->addWithLabel("CACHE ROM FOLDER SCANS", scan_cache);
+	s->addSaveFunc([scan_cache] { Settings::getInstance()->setBool("DirectoryScanCache", scan_cache->getState()); });
+
+	auto parallel_scan = std::make_shared<SwitchComponent>(mWindow);
+	parallel_scan->setState(Settings::getInstance()->getBool("ParallelFolderScan"));
+	s->addWithLabel("SCAN FOLDERS IN PARALLEL", parallel_scan);
+	s->addSaveFunc([parallel_scan] { Settings::getInstance()->setBool("ParallelFolderScan", parallel_scan->getState()); });
+
+	auto gamelist_snapshot = std::make_shared<SwitchComponent>(mWindow);
+	gamelist_snapshot->setState(Settings::getInstance()->getBool("GamelistSnapshot"));
+	s->addWithLabel("USE GAMELIST SNAPSHOTS", gamelist_snapshot);
+	s->addSaveFunc([gamelist_snapshot] { Settings::getInstance()->setBool("GamelistSnapshot", gamelist_snapshot->getState()); });
+
+	auto lazy_loading = std::make_shared<SwitchComponent>(mWindow);
+	lazy_loading->setState(Settings::getInstance()->getBool("LazySystemLoading"));
+	s->addWithLabel("LOAD SYSTEMS ON DEMAND", lazy_loading);
+	s->addSaveFunc([lazy_loading] { Settings::getInstance()->setBool("LazySystemLoading", lazy_loading->getState()); });
+
+	auto extension_case = std::make_shared<SwitchComponent>(mWindow);
+	extension_case->setState(Settings::getInstance()->getBool("IgnoreExtensionCase"));
+	s->addWithLabel("IGNORE EXTENSION CASE", extension_case);
+	s->addSaveFunc([extension_case] { Settings::getInstance()->setBool("IgnoreExtensionCase", extension_case->getState()); });
+
+	auto watch_folders = std::make_shared<SwitchComponent>(mWindow);
+	watch_folders->setState(Settings::getInstance()->getBool("WatchRomFolders"));
+	s->addWithLabel("WATCH ROM FOLDERS", watch_folders);
+	s->addSaveFunc([watch_folders] { Settings::getInstance()->setBool("WatchRomFolders", watch_folders->getState()); });
+
+	auto parallel_startup = std::make_shared<SwitchComponent>(mWindow);
+	parallel_startup->setState(Settings::getInstance()->getBool("ParallelStartup"));
+	s->addWithLabel("PARALLEL STARTUP", parallel_startup);
+	s->addSaveFunc([parallel_startup] { Settings::getInstance()->setBool("ParallelStartup", parallel_startup->getState()); });
+
 	auto local_art = std::make_shared<SwitchComponent>(mWindow);
 	local_art->setState(Settings::getInstance()->getBool("LocalArt"));
 	s->addWithLabel("SEARCH FOR LOCAL ART", local_art);
@@ -191,8 +191,9 @@ void GuiMetaDataEd::save()
 		mMetaData->set(mMetaDataDecl.at(i).key, mEditors.at(i)->getValue());
 	}
 
-	// enter game in index
+	// enter game in index, the search index picks it up on its next pass
 	mScraperParams.system->getIndex()->addToIndex(mScraperParams.game);
+	mScraperParams.system->invalidateMetaData();
 
 	if(mSavedCallback)
 		mSavedCallback();
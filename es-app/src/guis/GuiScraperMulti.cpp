@@ -6,7 +6,7 @@
 #include "components/TextComponent.h"
 #include "guis/GuiMsgBox.h"
 #include "views/ViewController.h"
-#include "Gamelist.h"
+#include "GamelistWriter.h"
 #include "PowerSaver.h"
 #include "SystemData.h"
 #include "Window.h"
@@ -114,7 +114,8 @@ void GuiScraperMulti::acceptResult(const ScraperSearchResult& result)
 	ScraperSearchParams& search = mSearchQueue.front();
 
 	search.game->metadata = result.mdl;
-	updateGamelist(search.system);
+	search.system->invalidateMetaData();
+	GamelistWriter::getInstance()->save(search.system);
 
 	mSearchQueue.pop();
 	mCurrentGame++;
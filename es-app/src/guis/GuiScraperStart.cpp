@@ -78,7 +78,8 @@ std::queue<ScraperSearchParams> GuiScraperStart::getSearches(std::vector<SystemD
 	std::queue<ScraperSearchParams> queue;
 	for(auto sys = systems.cbegin(); sys != systems.cend(); sys++)
 	{
-		std::vector<FileData*> games = (*sys)->getRootFolder()->getFilesRecursive(GAME);
+		(*sys)->loadGameListIfNeeded();
+		const std::vector<FileData*>& games = (*sys)->getGames();
 		for(auto game = games.cbegin(); game != games.cend(); game++)
 		{
 			if(selector((*sys), (*game)))
@@ -3,19 +3,26 @@
 
 #include "guis/GuiDetectDevice.h"
 #include "guis/GuiMsgBox.h"
+#include "resources/ResourceManager.h"
+#include "scrapers/Scraper.h"
 #include "utils/FileSystemUtil.h"
 #include "views/ViewController.h"
 #include "CollectionSystemManager.h"
 #include "EmulationStation.h"
+#include "GameSearchIndex.h"
+#include "GamelistWriter.h"
 #include "InputManager.h"
 #include "Log.h"
 #include "MameNames.h"
 #include "platform.h"
 #include "PowerSaver.h"
+#include "RomFolderWatcher.h"
 #include "ScraperCmdLine.h"
 #include "Settings.h"
+#include "StartupTasks.h"
 #include "SystemData.h"
 #include "SystemScreenSaver.h"
+#include "ThemeData.h"
 #include <SDL_events.h>
 #include <SDL_main.h>
 #include <SDL_timer.h>
@@ -27,6 +34,9 @@
 
 #include <FreeImage.h>
 
+// milliseconds of every frame the search index may take while it's built
+#define SEARCH_INDEX_FRAME_BUDGET 2
+
 bool scrape_cmdline = false;
 
 bool parseArgs(int argc, char* argv[])
@@ -214,11 +224,11 @@ bool verifyHomeFolderExists()
 }
 
 // Returns true if everything is OK,
-bool loadSystemConfigFile(const char** errorString)
+bool loadSystemConfigFile(Window* window, const char** errorString)
 {
 	*errorString = NULL;
 
-	if(!SystemData::loadConfig())
+	if(!SystemData::loadConfig(window))
 	{
 		LOG(LogError) << "Error while parsing systems configuration file!";
 		*errorString = "IT LOOKS LIKE YOUR SYSTEMS CONFIGURATION FILE HAS NOT BEEN SET UP OR IS INVALID. YOU'LL NEED TO DO THIS BY HAND, UNFORTUNATELY.\n\n"
@@ -304,12 +314,19 @@ int main(int argc, char* argv[])
 	//always close the log on exit
 	atexit(&onExit);
 
+	// the stages that neither need the window nor each other are loaded on worker threads while the splash screen comes up,
+	// the singletons they share with the main thread are created before
+	ResourceManager::getInstance();
+	StartupTasks startup(Settings::getInstance()->getBool("ParallelStartup"));
+	startup.add("mame names", [] { MameNames::init(); });
+	startup.add("theme sets", [] { ThemeData::getThemeSets(); });
+	startup.add("scraper resources", [] { loadScraperResources(); });
+
 	Window window;
 	SystemScreenSaver screensaver(&window);
 	PowerSaver::init();
 	ViewController::init(&window);
 	CollectionSystemManager::init(&window);
-	MameNames::init();
 	window.pushGui(ViewController::get());
 
 	bool splashScreen = Settings::getInstance()->getBool("SplashScreen");
@@ -317,7 +334,9 @@ int main(int argc, char* argv[])
 
 	if(!scrape_cmdline)
 	{
-		if(!window.init())
+		bool windowReady = false;
+		startup.run("window", [&] { windowReady = window.init(); });
+		if(!windowReady)
 		{
 			LOG(LogError) << "Window failed to initialize!";
 			return 1;
@@ -332,8 +351,11 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	// game names and theme paths are resolved while the systems load
 	const char* errorMsg = NULL;
-	if(!loadSystemConfigFile(&errorMsg))
+	bool systemsLoaded = false;
+	startup.run("systems", [&] { systemsLoaded = loadSystemConfigFile(scrape_cmdline ? nullptr : &window, &errorMsg); }, { "mame names", "theme sets" });
+	if(!systemsLoaded)
 	{
 		// something went terribly wrong
 		if(errorMsg == NULL)
@@ -357,6 +379,8 @@ int main(int argc, char* argv[])
 	//run the command line scraper then quit
 	if(scrape_cmdline)
 	{
+		// the scraper reads the resources the "scraper resources" stage may still be filling
+		startup.waitAll();
 		return run_scraper_cmdline();
 	}
 
@@ -365,11 +389,13 @@ int main(int argc, char* argv[])
 
 	// preload what we can right away instead of waiting for the user to select it
 	// this makes for no delays when accessing content, but a longer startup time
-	ViewController::get()->preload();
+	startup.run("preload", [] { ViewController::get()->preload(); });
 
 	if(splashScreen && splashScreenProgress)
 		window.renderLoadingScreen("Done.");
 
+	startup.logCriticalPath();
+
 	//choose which GUI to open depending on if an input configuration already exists
 	if(errorMsg == NULL)
 	{
@@ -434,6 +460,13 @@ int main(int argc, char* argv[])
 		if(deltaTime < 0)
 			deltaTime = 1000;
 
+		// apply games added to or removed from the rom folders, does nothing unless WatchRomFolders is set
+		RomFolderWatcher::getInstance()->update(&window);
+
+		// build the search index a little at a time so the frame rate doesn't suffer
+		if(Settings::getInstance()->getBool("SearchIndexInBackground"))
+			GameSearchIndex::updateAll(SEARCH_INDEX_FRAME_BUDGET);
+
 		window.update(deltaTime);
 		window.render();
 		Renderer::swapBuffers();
@@ -443,11 +476,17 @@ int main(int argc, char* argv[])
 
 	while(window.peekGui() != ViewController::get())
 		delete window.peekGui();
+
+	// the lazy loader still builds games, which use the singletons deinitialized below
+	SystemData::stopBackgroundLoading();
+
 	window.deinit();
 
+	RomFolderWatcher::deinit();
 	MameNames::deinit();
 	CollectionSystemManager::deinit();
 	SystemData::deleteSystems();
+	GamelistWriter::deinit();
 
 	// call this ONLY when linking with FreeImage as a static library
 #ifdef FREEIMAGE_LIB
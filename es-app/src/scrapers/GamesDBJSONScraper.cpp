@@ -103,6 +103,11 @@ const std::map<PlatformId, std::string> gamesdb_new_platformid_map{
 	{ TANDY, "4941" },
 };
 
+void thegamesdb_load_resources()
+{
+	resources.loadCached();
+}
+
 void thegamesdb_generate_json_scraper_requests(const ScraperSearchParams& params,
 	std::queue<std::unique_ptr<ScraperRequest>>& requests, std::vector<ScraperSearchResult>& results)
 {
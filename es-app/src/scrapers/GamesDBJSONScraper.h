@@ -12,6 +12,9 @@ class xml_document;
 void thegamesdb_generate_json_scraper_requests(const ScraperSearchParams& params,
 	std::queue<std::unique_ptr<ScraperRequest>>& requests, std::vector<ScraperSearchResult>& results);
 
+// reads the developer, publisher and genre lists downloaded earlier, missing ones are fetched by the first search
+void thegamesdb_load_resources();
+
 class TheGamesDBJSONRequest : public ScraperHttpRequest
 {
   public:
@@ -118,6 +118,18 @@ void TheGamesDBJSONRequestResources::ensureResources()
 	LOG(LogError) << "Timed out while waiting for resources\n";
 }
 
+void TheGamesDBJSONRequestResources::loadCached()
+{
+	if (checkLoaded())
+	{
+		return;
+	}
+
+	loadResource(gamesdb_new_developers_map, "developers", genFilePath(DEVELOPERS_JSON_FILE));
+	loadResource(gamesdb_new_publishers_map, "publishers", genFilePath(PUBLISHERS_JSON_FILE));
+	loadResource(gamesdb_new_genres_map, "genres", genFilePath(GENRES_JSON_FILE));
+}
+
 bool TheGamesDBJSONRequestResources::checkLoaded()
 {
 	return !gamesdb_new_genres_map.empty() && !gamesdb_new_developers_map.empty() && !gamesdb_new_publishers_map.empty();
@@ -15,6 +15,7 @@ struct TheGamesDBJSONRequestResources
 	TheGamesDBJSONRequestResources() = default;
 
 	void prepare();
+	void loadCached(); // only reads the resource files, without fetching the missing ones
 	void ensureResources();
 	std::string getApiKey() const;
 
@@ -49,6 +49,12 @@ bool isValidConfiguredScraper()
 	return scraper_request_funcs.find(name) != scraper_request_funcs.end();
 }
 
+void loadScraperResources()
+{
+	if(Settings::getInstance()->getString("Scraper") == "TheGamesDB")
+		thegamesdb_load_resources();
+}
+
 // ScraperSearchHandle
 ScraperSearchHandle::ScraperSearchHandle()
 {
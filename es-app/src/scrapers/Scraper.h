@@ -116,6 +116,9 @@ std::vector<std::string> getScraperList();
 // returns true if the scraper configured in the settings is still valid
 bool isValidConfiguredScraper();
 
+// reads the resources the configured scraper downloaded earlier, so the first search doesn't have to (safe to call from another thread before any search starts)
+void loadScraperResources();
+
 typedef void (*generate_scraper_requests_func)(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, std::vector<ScraperSearchResult>& results);
 
 // -------------------------------------------------------------------------
@@ -280,6 +280,7 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	if(exists != mGameListViews.cend())
 		return exists->second;
 
+	system->loadGameListIfNeeded();
 	system->getIndex()->setUIModeFilters();
 	//if we didn't, make it, remember it, and return it
 	std::shared_ptr<IGameListView> view;
@@ -301,20 +302,20 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 
 	if (selectedViewType == AUTOMATIC)
 	{
-		std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME | FOLDER);
-		for (auto it = files.cbegin(); it != files.cend(); it++)
+		system->getRootFolder()->visitFilesRecursive(GAME | FOLDER, false, [&](FileData* file) -> bool
 		{
-			if (themeHasVideoView && !(*it)->getVideoPath().empty())
+			if (themeHasVideoView && !file->getVideoPath().empty())
 			{
 				selectedViewType = VIDEO;
-				break;
+				return false;
 			}
-			else if (!(*it)->getThumbnailPath().empty())
+			else if (!file->getThumbnailPath().empty())
 			{
 				selectedViewType = DETAILED;
 				// Don't break out in case any subsequent files have video
 			}
-		}
+			return true;
+		});
 	}
 
 	// Create the view
@@ -439,6 +440,10 @@ void ViewController::preload()
 	uint32_t i = 0;
 	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
 	{
+		// systems that are loaded on demand get their view when they're first opened
+		if(!(*it)->isGameListLoaded())
+			continue;
+
 		if(Settings::getInstance()->getBool("SplashScreen") &&
 			Settings::getInstance()->getBool("SplashScreenProgress"))
 		{
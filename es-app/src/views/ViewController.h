@@ -82,6 +82,7 @@ public:
 	virtual HelpStyle getHelpStyle() override;
 
 	std::shared_ptr<IGameListView> getGameListView(SystemData* system);
+	inline bool hasGameListView(SystemData* system) const { return mGameListViews.find(system) != mGameListViews.cend(); } // without creating it
 	std::shared_ptr<SystemView> getSystemListView();
 	void removeGameListView(SystemData* system);
 
@@ -119,7 +119,7 @@ void BasicGameListView::remove(FileData *game, bool deleteFile)
 	FileData* parent = game->getParent();
 	if (getCursor() == game)                     // Select next element in list, or prev if none
 	{
-		std::vector<FileData*> siblings = parent->getChildrenListToDisplay();
+		const std::vector<FileData*>& siblings = parent->getChildrenListToDisplay();
 		auto gameIter = std::find(siblings.cbegin(), siblings.cend(), game);
 		unsigned int gamePos = (int)std::distance(siblings.cbegin(), gameIter);
 		if (gameIter != siblings.cend())
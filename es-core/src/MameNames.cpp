@@ -6,6 +6,16 @@
 #include <pugixml/src/pugixml.hpp>
 #include <string.h>
 
+#if defined(MAMENAMES_BUILTIN)
+// generated from resources/mame*.xml by CMake/Utils/GenerateMameNames.cmake
+extern const char* const gMameNames[][2];
+extern const size_t      gMameNameCount;
+extern const char* const gMameBioses[];
+extern const size_t      gMameBiosCount;
+extern const char* const gMameDevices[];
+extern const size_t      gMameDeviceCount;
+#endif // MAMENAMES_BUILTIN
+
 MameNames* MameNames::sInstance = nullptr;
 
 void MameNames::init()
@@ -35,6 +45,39 @@ MameNames* MameNames::getInstance()
 } // getInstance
 
 MameNames::MameNames()
+{
+#if defined(MAMENAMES_BUILTIN)
+	loadBuiltin();
+#else
+	loadXML();
+#endif
+
+} // MameNames
+
+MameNames::~MameNames()
+{
+
+} // ~MameNames
+
+void MameNames::loadBuiltin()
+{
+#if defined(MAMENAMES_BUILTIN)
+	mNamePairs.reserve(gMameNameCount);
+	for(size_t i = 0; i < gMameNameCount; ++i)
+		mNamePairs.insert(std::make_pair(gMameNames[i][0], gMameNames[i][1]));
+
+	for(size_t i = 0; i < gMameBiosCount; ++i)
+		mMameBioses.insert(gMameBioses[i]);
+
+	for(size_t i = 0; i < gMameDeviceCount; ++i)
+		mMameDevices.insert(gMameDevices[i]);
+
+	LOG(LogInfo) << "Using the built-in MAME names (" << mNamePairs.size() << " names, " << mMameBioses.size() << " bioses, " << mMameDevices.size() << " devices)";
+#endif // MAMENAMES_BUILTIN
+
+} // loadBuiltin
+
+void MameNames::loadXML()
 {
 	std::string xmlpath = ResourceManager::getInstance()->getResourcePath(":/mamenames.xml");
 
@@ -52,10 +95,12 @@ MameNames::MameNames()
 		return;
 	}
 
+	// the first entry wins if a name is listed twice
 	for(pugi::xml_node gameNode = doc.child("game"); gameNode; gameNode = gameNode.next_sibling("game"))
 	{
-		NamePair namePair = { gameNode.child("mamename").text().get(), gameNode.child("realname").text().get() };
-		mNamePairs.push_back(namePair);
+		const char* mameName = gameNode.child("mamename").text().get();
+		if(mNamePairs.find(mameName) == mNamePairs.cend())
+			mNamePairs.insert(std::make_pair(store(mameName), store(gameNode.child("realname").text().get())));
 	}
 
 	// Read bios
@@ -76,8 +121,9 @@ MameNames::MameNames()
 
 	for(pugi::xml_node biosNode = doc.child("bios"); biosNode; biosNode = biosNode.next_sibling("bios"))
 	{
-		std::string bios = biosNode.text().get();
-		mMameBioses.push_back(bios);
+		const char* bios = biosNode.text().get();
+		if(mMameBioses.find(bios) == mMameBioses.cend())
+			mMameBioses.insert(store(bios));
 	}
 
 	// Read devices
@@ -98,31 +144,25 @@ MameNames::MameNames()
 
 	for(pugi::xml_node deviceNode = doc.child("device"); deviceNode; deviceNode = deviceNode.next_sibling("device"))
 	{
-		std::string device = deviceNode.text().get();
-		mMameDevices.push_back(device);
+		const char* device = deviceNode.text().get();
+		if(mMameDevices.find(device) == mMameDevices.cend())
+			mMameDevices.insert(store(device));
 	}
 
-} // MameNames
+} // loadXML
 
-MameNames::~MameNames()
+const char* MameNames::store(const char* _string)
 {
+	mStrings.push_back(_string);
+	return mStrings.back().c_str();
 
-} // ~MameNames
+} // store
 
 std::string MameNames::getRealName(const std::string& _mameName)
 {
-	size_t start = 0;
-	size_t end   = mNamePairs.size();
-
-	while(start < end)
-	{
-		const size_t index   = (start + end) / 2;
-		const int    compare = strcmp(mNamePairs[index].mameName.c_str(), _mameName.c_str());
-
-		if(compare < 0)       start = index + 1;
-		else if( compare > 0) end   = index;
-		else                  return mNamePairs[index].realName;
-	}
+	nameMap::const_iterator it = mNamePairs.find(_mameName.c_str());
+	if(it != mNamePairs.cend())
+		return it->second;
 
 	return _mameName;
 
@@ -130,31 +170,29 @@ std::string MameNames::getRealName(const std::string& _mameName)
 
 const bool MameNames::isBios(const std::string& _biosName)
 {
-	return MameNames::find(mMameBioses, _biosName);
+	return mMameBioses.find(_biosName.c_str()) != mMameBioses.cend();
 
 } // isBios
 
 const bool MameNames::isDevice(const std::string& _deviceName)
 {
-	return MameNames::find(mMameDevices, _deviceName);
+	return mMameDevices.find(_deviceName.c_str()) != mMameDevices.cend();
 
 } // isDevice
 
-const bool MameNames::find(std::vector<std::string> devices, const std::string& name)
+size_t MameNames::Hash::operator()(const char* _string) const
 {
-	size_t start = 0;
-	size_t end   = devices.size();
+	// FNV-1a
+	size_t hash = 2166136261u;
+	for(const unsigned char* c = (const unsigned char*)_string; *c; ++c)
+		hash = (hash ^ *c) * 16777619u;
 
-	while(start < end)
-	{
-		const size_t index   = (start + end) / 2;
-		const int    compare = strcmp(devices[index].c_str(), name.c_str());
+	return hash;
 
-		if(compare < 0)       start = index + 1;
-		else if( compare > 0) end   = index;
-		else                  return true;
-	}
+} // Hash
 
-	return false;
+bool MameNames::Equal::operator()(const char* _a, const char* _b) const
+{
+	return strcmp(_a, _b) == 0;
 
-}
+} // Equal
@@ -2,9 +2,14 @@
 #ifndef ES_CORE_MAMENAMES_H
 #define ES_CORE_MAMENAMES_H
 
+#include <deque>
+#include <stddef.h>
 #include <string>
-#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
+// The real names of MAME sets and the sets that are BIOSes or devices. Read from resources/mame*.xml,
+// or from tables compiled in from the same files when built with MAMENAMES_BUILTIN. All lookups are hashed.
 class MameNames
 {
 public:
@@ -18,24 +23,26 @@ public:
 
 private:
 
-	struct NamePair
-	{
-		std::string mameName;
-		std::string realName;
-	};
+	// the tables only point to their names, kept in mStrings or compiled in
+	struct Hash  { size_t operator()(const char* _string) const; };
+	struct Equal { bool   operator()(const char* _a, const char* _b) const; };
 
-	typedef std::vector<NamePair> namePairVector;
+	typedef std::unordered_map<const char*, const char*, Hash, Equal> nameMap;
+	typedef std::unordered_set<const char*, Hash, Equal>              nameSet;
 
 	 MameNames();
 	~MameNames();
 
 	static MameNames* sInstance;
 
-	namePairVector mNamePairs;
-	std::vector<std::string> mMameBioses;
-	std::vector<std::string> mMameDevices;
+	void        loadBuiltin();
+	void        loadXML    ();
+	const char* store      (const char* _string);
 
-	const bool find(const std::vector<std::string> devices, const std::string& name);
+	nameMap                 mNamePairs;
+	nameSet                 mMameBioses;
+	nameSet                 mMameDevices;
+	std::deque<std::string> mStrings; // a deque never moves its elements, the pointers above stay valid
 
 }; // MameNames
 
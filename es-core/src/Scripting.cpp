@@ -24,15 +24,17 @@ namespace Scripting
         int ret = 0;
         // loop over found script paths per event and over scripts found in eventName folder.
         for(std::list<std::string>::const_iterator dirIt = scriptDirList.cbegin(); dirIt != scriptDirList.cend(); ++dirIt) {
-            std::list<std::string> scripts = Utils::FileSystem::getDirContent(*dirIt);
-            for (std::list<std::string>::const_iterator it = scripts.cbegin(); it != scripts.cend(); ++it) {
+            Utils::FileSystem::dirEntryList scripts = Utils::FileSystem::getDirEntries(*dirIt);
+            for (Utils::FileSystem::dirEntryList::const_iterator it = scripts.cbegin(); it != scripts.cend(); ++it) {
+                if (it->isDirectory)
+                    continue;
+                std::string script = Utils::FileSystem::getGenericPath(*dirIt + "/" + it->name);
 #ifndef WIN32 // osx / linux
-                if (!Utils::FileSystem::isExecutable(*it)) {
-                    LOG(LogWarning) << *it << " is not executable. Did you 'chmod u+x'?. Skipping this script.";
+                if (!Utils::FileSystem::isExecutable(script)) {
+                    LOG(LogWarning) << script << " is not executable. Did you 'chmod u+x'?. Skipping this script.";
                     continue;
                 }
 #endif
-                std::string script = *it;
                 if (arg1.length() > 0) {
                     script += " \"" + arg1 + "\"";
                     if (arg2.length() > 0) {
@@ -57,6 +57,17 @@ void Settings::setDefaults()
 
 	mBoolMap["BackgroundJoystickInput"] = false;
 	mBoolMap["ParseGamelistOnly"] = false;
+	mBoolMap["ParallelSystemLoading"] = false;
+	mBoolMap["DirectoryScanCache"] = true;
+	mBoolMap["ParallelFolderScan"] = false;
+	mBoolMap["GamelistSnapshot"] = true;
+	mBoolMap["MetaDataJournal"] = true;
+	mBoolMap["SaveGamelistsInBackground"] = true;
+	mBoolMap["SearchIndexInBackground"] = true;
+	mBoolMap["LazySystemLoading"] = false;
+	mBoolMap["IgnoreExtensionCase"] = false;
+	mBoolMap["WatchRomFolders"] = false;
+	mBoolMap["ParallelStartup"] = false;
 	mBoolMap["ShowHiddenFiles"] = false;
 	mBoolMap["DrawFramerate"] = false;
 	mBoolMap["ShowExit"] = true;
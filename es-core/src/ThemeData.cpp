@@ -9,6 +9,7 @@
 #include "Settings.h"
 #include <pugixml/src/pugixml.hpp>
 #include <algorithm>
+#include <mutex>
 
 std::vector<std::string> ThemeData::sSupportedViews { { "system" }, { "basic" }, { "detailed" }, { "grid" }, { "video" } };
 std::vector<std::string> ThemeData::sSupportedFeatures { { "video" }, { "carousel" }, { "z-index" }, { "visible" } };
@@ -577,8 +578,6 @@ std::vector<GuiComponent*> ThemeData::makeExtras(const std::shared_ptr<ThemeData
 
 std::map<std::string, ThemeSet> ThemeData::getThemeSets()
 {
-	std::map<std::string, ThemeSet> sets;
-
 	static const size_t pathCount = 2;
 	std::string paths[pathCount] =
 	{
@@ -586,6 +585,23 @@ std::map<std::string, ThemeSet> ThemeData::getThemeSets()
 		Utils::FileSystem::getHomePath() + "/.emulationstation/themes"
 	};
 
+	// every system asks for the current set when its theme is loaded, only list the theme folders again
+	// once one of them changed (adding or removing a theme updates the modification time of the folder)
+	static std::mutex cacheMutex;
+	static std::map<std::string, ThemeSet> cachedSets;
+	static long long cachedModified[pathCount] = { -1, -1 };
+
+	long long modified[pathCount];
+	for(size_t i = 0; i < pathCount; i++)
+		modified[i] = Utils::FileSystem::getModifiedTime(paths[i]);
+
+	std::unique_lock<std::mutex> lock(cacheMutex);
+
+	if(std::equal(modified, modified + pathCount, cachedModified))
+		return cachedSets;
+
+	std::map<std::string, ThemeSet> sets;
+
 	for(size_t i = 0; i < pathCount; i++)
 	{
 		if(!Utils::FileSystem::isDirectory(paths[i]))
@@ -603,6 +619,9 @@ std::map<std::string, ThemeSet> ThemeData::getThemeSets()
 		}
 	}
 
+	cachedSets = sets;
+	std::copy(modified, modified + pathCount, cachedModified);
+
 	return sets;
 }
 
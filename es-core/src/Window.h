@@ -76,6 +76,7 @@ public:
 	void startScreenSaver();
 	bool cancelScreenSaver();
 	void renderScreenSaver();
+	inline bool isScreenSaverActive() const { return mRenderScreenSaver; }
 
 private:
 	void onSleep();
@@ -3,6 +3,7 @@
 #include "utils/FileSystemUtil.h"
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <string.h>
 
 #if defined(_WIN32)
@@ -18,6 +19,7 @@
 #define S_ISDIR(x) (((x) & S_IFMT) == S_IFDIR)
 #else // _WIN32
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 #endif // _WIN32
 
@@ -114,6 +116,118 @@ namespace Utils
 
 		} // getDirContent
 
+		static void appendDirEntries(const std::string& _path, const std::string& _prefix, const bool _recursive, dirEntryList& _entries)
+		{
+
+#if defined(_WIN32)
+			WIN32_FIND_DATAW findData;
+			std::string      wildcard = _path + "/*";
+			HANDLE           hFind    = FindFirstFileW(std::wstring(wildcard.begin(), wildcard.end()).c_str(), &findData);
+
+			if(hFind != INVALID_HANDLE_VALUE)
+			{
+				// loop over all files in the directory
+				do
+				{
+					std::string name = convertFromWideString(findData.cFileName);
+
+					// ignore "." and ".."
+					if((name == ".") || (name == ".."))
+						continue;
+
+					DirEntry entry;
+					entry.name          = _prefix + name;
+					entry.isDirectory   = ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+					entry.isRegularFile = !entry.isDirectory;
+					entry.isSymlink     = ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0);
+					entry.isHidden      = ((name[0] == '.') || ((findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0));
+					_entries.push_back(entry);
+
+					if(_recursive && entry.isDirectory)
+						appendDirEntries(_path + "/" + name, entry.name + "/", true, _entries);
+				}
+				while(FindNextFileW(hFind, &findData));
+
+				FindClose(hFind);
+			}
+#else // _WIN32
+			DIR* dir = opendir(_path.c_str());
+
+			if(dir != NULL)
+			{
+				struct dirent* dirEntry;
+
+				// loop over all files in the directory
+				while((dirEntry = readdir(dir)) != NULL)
+				{
+					const char* name = dirEntry->d_name;
+
+					// ignore "." and ".."
+					if((name[0] == '.') && ((name[1] == '\0') || ((name[1] == '.') && (name[2] == '\0'))))
+						continue;
+
+					DirEntry entry;
+					entry.name          = _prefix + name;
+					entry.isDirectory   = false;
+					entry.isRegularFile = false;
+					entry.isSymlink     = false;
+					entry.isHidden      = (name[0] == '.');
+
+					// the type usually comes with the entry itself, only stat symlinks (to know what they point to)
+					// and filesystems that don't fill in d_type
+					unsigned char type = dirEntry->d_type;
+					if(type == DT_UNKNOWN)
+					{
+						struct stat info;
+						if(fstatat(dirfd(dir), name, &info, AT_SYMLINK_NOFOLLOW) == 0)
+						{
+							if(S_ISLNK(info.st_mode))      type = DT_LNK;
+							else if(S_ISDIR(info.st_mode)) type = DT_DIR;
+							else if(S_ISREG(info.st_mode)) type = DT_REG;
+						}
+					}
+
+					if(type == DT_LNK)
+					{
+						struct stat info;
+						entry.isSymlink = true;
+						if(fstatat(dirfd(dir), name, &info, 0) == 0)
+						{
+							entry.isDirectory   = S_ISDIR(info.st_mode);
+							entry.isRegularFile = S_ISREG(info.st_mode);
+						}
+					}
+					else
+					{
+						entry.isDirectory   = (type == DT_DIR);
+						entry.isRegularFile = (type == DT_REG);
+					}
+
+					_entries.push_back(entry);
+
+					if(_recursive && entry.isDirectory)
+						appendDirEntries(_path + "/" + name, entry.name + "/", true, _entries);
+				}
+
+				closedir(dir);
+			}
+#endif // _WIN32
+
+		} // appendDirEntries
+
+		dirEntryList getDirEntries(const std::string& _path, const bool _recursive)
+		{
+			dirEntryList entries;
+
+			appendDirEntries(getGenericPath(_path), "", _recursive, entries);
+
+			// sort the entries like getDirContent does
+			std::sort(entries.begin(), entries.end(), [](const DirEntry& a, const DirEntry& b) { return a.name < b.name; });
+
+			return entries;
+
+		} // getDirEntries
+
 		stringList getPathList(const std::string& _path)
 		{
 			stringList  pathList;
@@ -233,26 +347,35 @@ namespace Utils
 			return path;
 		}
 
-		std::string getGenericPath(const std::string& _path)
+		static void makeGenericPath(std::string& _path)
 		{
-			std::string path   = _path;
-			size_t      offset = std::string::npos;
-
 			// remove "\\\\?\\"
-			if((path.find("\\\\?\\")) == 0)
-				path.erase(0, 4);
+			if(_path.compare(0, 4, "\\\\?\\") == 0)
+				_path.erase(0, 4);
 
-			// convert '\\' to '/'
-			while((offset = path.find('\\')) != std::string::npos)
-				path.replace(offset, 1 ,"/");
+			// convert '\\' to '/' and remove double '/' in a single pass
+			size_t length = 0;
+			for(size_t i = 0; i < _path.length(); ++i)
+			{
+				const char c = (_path[i] == '\\') ? '/' : _path[i];
+				if((c == '/') && (length > 0) && (_path[length - 1] == '/'))
+					continue;
 
-			// remove double '/'
-			while((offset = path.find("//")) != std::string::npos)
-				path.erase(offset, 1);
+				_path[length++] = c;
+			}
+			_path.resize(length);
 
 			// remove trailing '/' when the path is more than a simple '/'
-			while(path.length() > 1 && ((offset = path.find_last_of('/')) == (path.length() - 1)))
-				path.erase(offset, 1);
+			while((_path.length() > 1) && (_path[_path.length() - 1] == '/'))
+				_path.erase(_path.length() - 1, 1);
+
+		} // makeGenericPath
+
+		std::string getGenericPath(const std::string& _path)
+		{
+			std::string path = _path;
+
+			makeGenericPath(path);
 
 			// return generic path
 			return path;
@@ -483,6 +606,25 @@ namespace Utils
 
 		} // resolveRelativePath2
 
+		void resolveRelativePath(const char* _path, const std::string& _relativeTo, const bool _allowHome, std::string& _result)
+		{
+			_result.assign(_path);
+			makeGenericPath(_result);
+
+			// nothing to resolve
+			if(!_result.length())
+				return;
+
+			// replace '.' with relativeTo
+			if((_result[0] == '.') && (_result[1] == '/'))
+				_result.replace(0, 1, _relativeTo);
+
+			// replace '~' with homePath
+			else if(_allowHome && (_result[0] == '~') && (_result[1] == '/'))
+				_result.replace(0, 1, getHomePath());
+
+		} // resolveRelativePath
+
 		std::string createRelativePath(const std::string& _path, const std::string& _relativeTo, const bool _allowHome)
 		{
 			bool        contains = false;
@@ -708,6 +850,41 @@ namespace Utils
 			return false;
 
 		} // isHidden
+
+		long long getModifiedTime(const std::string& _path)
+		{
+			return getFileInfo(_path).modified;
+
+		} // getModifiedTime
+
+		FileInfo getFileInfo(const std::string& _path)
+		{
+			std::string path = getGenericPath(_path);
+			struct stat64 info;
+			FileInfo fileInfo = { false, false, 0, 0, 0 };
+
+			// check if stat64 succeeded
+			if(stat64(path.c_str(), &info) != 0)
+				return fileInfo;
+
+			fileInfo.exists      = true;
+			fileInfo.isDirectory = S_ISDIR(info.st_mode);
+#if defined(_WIN32)
+			// st_ino is always 0 and st_dev is only the drive number on windows
+			fileInfo.modified    = ((long long)info.st_mtime * 1000000000LL);
+#else // _WIN32
+			fileInfo.device      = (unsigned long long)info.st_dev;
+			fileInfo.inode       = (unsigned long long)info.st_ino;
+#if defined(__linux__)
+			fileInfo.modified    = ((long long)info.st_mtim.tv_sec * 1000000000LL) + info.st_mtim.tv_nsec;
+#else // __linux__
+			fileInfo.modified    = ((long long)info.st_mtime * 1000000000LL);
+#endif // __linux__
+#endif // _WIN32
+
+			return fileInfo;
+
+		} // getFileInfo
 #ifndef WIN32 // osx / linux
 		bool isExecutable(const std::string& _path) {
 			struct stat64 st;
@@ -4,6 +4,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 namespace Utils
 {
@@ -11,7 +12,30 @@ namespace Utils
 	{
 		typedef std::list<std::string> stringList;
 
-		stringList  getDirContent      (const std::string& _path, const bool _recursive = false);
+		// a directory entry as returned by getDirEntries, the flags are filled from the same listing pass
+		// so callers don't need to stat every entry again
+		struct DirEntry
+		{
+			std::string name;          // relative to the listed directory, contains the subdirectory for recursive listings
+			bool        isDirectory;   // symlinks are followed, like isDirectory()
+			bool        isRegularFile; // symlinks are followed, like isRegularFile()
+			bool        isSymlink;
+			bool        isHidden;
+		};
+		typedef std::vector<DirEntry> dirEntryList;
+
+		// what a single stat of a path tells, symlinks are followed
+		struct FileInfo
+		{
+			bool               exists;
+			bool               isDirectory;
+			unsigned long long device; // device and inode are 0 where the platform doesn't provide them
+			unsigned long long inode;
+			long long          modified; // see getModifiedTime()
+		};
+
+		stringList   getDirContent      (const std::string& _path, const bool _recursive = false);
+		dirEntryList getDirEntries      (const std::string& _path, const bool _recursive = false);
 		stringList  getPathList        (const std::string& _path);
 		void        setHomePath        (const std::string& _path);
 		std::string getHomePath        ();
@@ -35,6 +59,8 @@ namespace Utils
 		// Source: https://retropie.org.uk/forum/topic/25571/improve-gamelist-parsing-for-large-rom-collection-in-emulationstation-for-windows
 		std::string resolveRelativePath2(const std::string& _path, const std::string& _relativeTo, const bool _allowHome);
 		std::string removeCommonPath2(const std::string& _path, const std::string& _common, bool& _contains);
+		// same as resolveRelativePath2, but reuses the storage of _result, _relativeTo must already be a generic path
+		void        resolveRelativePath(const char* _path, const std::string& _relativeTo, const bool _allowHome, std::string& _result);
 		std::string removeCommonPath   (const std::string& _path, const std::string& _common, bool& _contains);
 		std::string resolveSymlink     (const std::string& _path);
 		bool        removeFile         (const std::string& _path);
@@ -45,6 +71,8 @@ namespace Utils
 		bool        isDirectory        (const std::string& _path);
 		bool        isSymlink          (const std::string& _path);
 		bool        isHidden           (const std::string& _path);
+		long long   getModifiedTime    (const std::string& _path); // in nanoseconds where the platform provides it, 0 if the path doesn't exist
+		FileInfo    getFileInfo        (const std::string& _path);
 #ifndef WIN32 // osx / linux
 		bool        isExecutable       (const std::string& _path);
 #endif